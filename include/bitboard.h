@@ -0,0 +1,255 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+
+#include "types.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// The PEXT slider path needs an x86-64 target. The instruction is emitted through inline assembly
+// so one binary runs everywhere; initBitboards() only selects it when the CPU supports BMI2.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HAS_PEXT 1
+#else
+#define HAS_PEXT 0
+#endif
+
+/*
+A bitboard is a set of squares stored in a 64 bit integer. Bit n is set when square n
+(see squareIndex) is in the set.
+*/
+typedef uint64_t Bitboard;
+
+inline Bitboard squareBB(int sq) {
+    return Bitboard(1) << sq;
+}
+
+// Squares of the a-file and h-file, used to stop diagonal shifts wrapping around the board
+const Bitboard FileABB = 0x0101010101010101ULL;
+const Bitboard FileHBB = FileABB << 7;
+
+/**
+ * @brief The eight squares of a rank. Rank 0 is the 8th rank, see squareIndex.
+ */
+inline Bitboard rankBB(int rank) {
+    return Bitboard(0xFF) << (8 * rank);
+}
+
+/**
+ * @brief Moves every square of the bitboard by D square indices: -8 or 8 for one rank towards rank 0
+ * or rank 7, and -9, -7, 7 or 9 for one diagonal step. Squares that would leave the board over the
+ * a-file or h-file are dropped.
+ */
+template<int D>
+inline Bitboard shift(Bitboard b) {
+    return (D == -8) ? b >> 8
+         : (D ==  8) ? b << 8
+         : (D == -9) ? (b & ~FileABB) >> 9
+         : (D == -7) ? (b & ~FileHBB) >> 7
+         : (D ==  7) ? (b & ~FileABB) << 7
+         : (D ==  9) ? (b & ~FileHBB) << 9
+         : 0;
+}
+
+/**
+ * @brief Number of squares in the bitboard.
+ */
+inline int popCount(Bitboard b) {
+#if defined(_MSC_VER)
+    return int(__popcnt64(b));
+#else
+    return __builtin_popcountll(b);
+#endif
+}
+
+/**
+ * @brief Index of the least significant set square. The bitboard must not be empty.
+ */
+inline int lsb(Bitboard b) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, b);
+    return int(idx);
+#else
+    return __builtin_ctzll(b);
+#endif
+}
+
+/**
+ * @brief Removes the least significant square from the bitboard and returns its index.
+ * The bitboard must not be empty.
+ */
+inline int popLSB(Bitboard& b) {
+    int sq = lsb(b);
+    b &= b - 1;
+    return sq;
+}
+
+/**
+ * @brief Parallel bit extract: gathers the bits of b selected by mask into the low bits of the result.
+ * Only valid when the CPU supports BMI2, see sliderAttackPath.
+ */
+inline Bitboard pext(Bitboard b, Bitboard mask) {
+#if defined(__BMI2__)
+    return _pext_u64(b, mask);
+#elif HAS_PEXT
+    Bitboard result;
+    __asm__("pextq %2, %1, %0" : "=r"(result) : "r"(b), "r"(mask));
+    return result;
+#else
+    (void)b;
+    (void)mask;
+    return 0;
+#endif
+}
+
+// Ways of turning the blockers of a slider into an index of its attack table
+enum SliderAttackPath {
+    MAGIC_ATTACKS,  // multiply by a magic number and keep the top bits, runs on any CPU
+    PEXT_ATTACKS    // extract the blocker bits with BMI2 PEXT, x86-64 CPUs with fast BMI2 only
+};
+
+// Path picked for this host by initBitboards(). Read on every slider lookup.
+extern SliderAttackPath sliderAttackPath;
+
+/*
+Magic bitboard entry of one slider on one square. The occupied squares inside the mask are
+multiplied by the magic number and the top bits of the product index the square's slice of
+the attack table. On the PEXT path the same bits are gathered with one instruction instead.
+*/
+struct Magic {
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard* attacks;
+    unsigned shift;
+
+    unsigned index(Bitboard occupied) const {
+#if HAS_PEXT
+        if (sliderAttackPath == PEXT_ATTACKS)
+            return unsigned(pext(occupied, mask));
+#endif
+        return unsigned(((occupied & mask) * magic) >> shift);
+    }
+};
+
+extern Magic RookMagics[64];
+extern Magic BishopMagics[64];
+
+// Squares attacked by a knight, a king, and a pawn of each color from every square
+extern Bitboard KnightAttacks[64];
+extern Bitboard KingAttacks[64];
+extern Bitboard PawnAttacks[2][64];
+
+// For two squares on a common rank, file or diagonal: the squares strictly between them, and the 
+// whole line through both (edge to edge). Empty if the squares are not aligned
+extern Bitboard BetweenBB[64][64];
+extern Bitboard LineBB[64][64];
+
+/**
+ * @brief Builds the slider, knight, king and pawn attack tables and the line tables. They are shared by every Board and every thread, and
+ * are only built on the first call; later calls return immediately. Called by the Board constructors.
+ * 
+ * The first call detects the CPU and picks PEXT_ATTACKS when BMI2 is available and fast (AMD
+ * CPUs before Zen 3 run PEXT in microcode), MAGIC_ATTACKS otherwise. The environment variable
+ * CHESS_SLIDER_ATTACKS=magic or =pext overrides the choice. The path is logged to std::cerr.
+ */
+void initBitboards();
+
+/**
+ * @brief Returns true if this CPU can run the PEXT path.
+ */
+bool cpuSupportsPext();
+
+/**
+ * @brief Rebuilds the slider tables for the given path, used by benchmarks and tests to compare
+ * both paths on one host. Falls back to MAGIC_ATTACKS if the CPU can not run PEXT. Must not be
+ * called while other threads are generating moves.
+ * 
+ * @param path - path to switch to
+ * @return SliderAttackPath - path now in use
+ */
+SliderAttackPath setSliderAttackPath(SliderAttackPath path);
+
+/**
+ * @brief Name of the slider path in use, "magic" or "pext".
+ */
+const char* sliderAttackPathName();
+
+/**
+ * @brief Squares attacked by a rook on sq, including the first blocker of each ray.
+ * 
+ * @param sq - square index of the rook
+ * @param occupied - occupied squares of the board
+ * @return Bitboard - attacked squares
+ */
+inline Bitboard rookAttacks(int sq, Bitboard occupied) {
+    const Magic& m = RookMagics[sq];
+    return m.attacks[m.index(occupied)];
+}
+
+/**
+ * @brief Squares attacked by a bishop on sq, including the first blocker of each ray.
+ * 
+ * @param sq - square index of the bishop
+ * @param occupied - occupied squares of the board
+ * @return Bitboard - attacked squares
+ */
+inline Bitboard bishopAttacks(int sq, Bitboard occupied) {
+    const Magic& m = BishopMagics[sq];
+    return m.attacks[m.index(occupied)];
+}
+
+/**
+ * @brief Squares attacked by a queen on sq, the union of the rook and bishop attacks.
+ */
+inline Bitboard queenAttacks(int sq, Bitboard occupied) {
+    return rookAttacks(sq, occupied) | bishopAttacks(sq, occupied);
+}
+
+/**
+ * @brief Squares attacked by a knight on sq.
+ */
+inline Bitboard knightAttacks(int sq) {
+    return KnightAttacks[sq];
+}
+
+/**
+ * @brief Squares attacked by a king on sq.
+ */
+inline Bitboard kingAttacks(int sq) {
+    return KingAttacks[sq];
+}
+
+/**
+ * @brief Squares strictly between a and b if they share a rank, file or diagonal, empty otherwise.
+ */
+inline Bitboard betweenBB(int a, int b) {
+    return BetweenBB[a][b];
+}
+
+/**
+ * @brief The full rank, file or diagonal through a and b, empty if they are not aligned.
+ */
+inline Bitboard lineBB(int a, int b) {
+    return LineBB[a][b];
+}
+
+/**
+ * @brief Squares attacked by a pawn of color c on sq: the two squares diagonally in front of it.
+ * 
+ * @param c - color of the pawn. White pawns move towards rank 0 (the 8th rank)
+ * @param sq - square index of the pawn
+ * @return Bitboard - attacked squares
+ */
+inline Bitboard pawnAttacks(Color c, int sq) {
+    return PawnAttacks[c][sq];
+}
+
+#endif
@@ -3,6 +3,11 @@
 
 #include "castlingRights.h"
 #include "square.h"
+#include "bitboard.h"
+#include "movelist.h"
+#include "psqt.h"
+#include "types.h"
+#include "zobrist.h"
 #include <iostream>
 #include <vector>
 #include <algorithm>
@@ -29,12 +34,55 @@ struct Check {
 };
 
 
+// Which legal moves a generator stage produces. Captures include en passant and every promotion;
+// quiets are the remaining moves, castling included
+enum GenType {
+    GEN_CAPTURES,
+    GEN_QUIETS,
+    GEN_ALL
+};
+
+/*
+Everything makeMove changes that can not be recomputed from the move itself. makeMove pushes one of 
+these on the undo stack and unmakeMove pops it to restore the position.
+*/
+struct UndoInfo {
+    // Piece captured by the move, NO_PIECE if the move is not a capture
+    Piece captured;
+
+    // Game state before the move
+    CastlingRights castlingRights;
+    int enPassantSquare;
+    int halfMove;
+
+    // Zobrist key of the position before the move
+    Key key;
+};
+
+
 class Board {
 
 private:
 
-    // 8x8 vector of Squares to represent the board
-    std::vector<std::vector<Square> > board;
+    // One bitboard per color and piece type, indexed [Color][PieceType]. Kept up to date by makeMove, they serve
+    // as the piece lists of the generators, which visit only the occupied squares of the side to move
+    Bitboard pieceBB[2][6];
+
+    // Occupancy of each color and of the whole board
+    Bitboard colorBB[2];
+    Bitboard occupiedBB;
+
+    // Piece on each square, indexed by squareIndex(rank, file). NO_PIECE if the square is empty
+    Piece mailbox[64];
+
+    // Zobrist key of the position, kept up to date by makeMove and unmakeMove
+    Key key;
+
+    // Piece-square table sums from white's point of view and the game phase, kept up to date with the pieces
+    // like the key, see psqt.h
+    int psqMidgame;
+    int psqEndgame;
+    int phase;
 
     // Active color
     bool whiteToPlay;
@@ -42,13 +90,16 @@ private:
     // Castling rights
     CastlingRights castlingRights;
 
-    // En Passant targets
-    std::string enPassantTargets;
+    // En passant target square index, -1 if there is none
+    int enPassantSquare;
 
     // Halfmove and full move count
     int halfMove;
     int moveNumber;
 
+    // One UndoInfo per move played with makeMove and not yet taken back
+    std::vector<UndoInfo> undoStack;
+
     /**
      * @brief Helper method for loading the board from a FEN string. The 6 components of a FEN string are
      *  1. position
@@ -69,6 +120,127 @@ private:
      */
     void initBoard();
 
+    /**
+     * @brief Places a piece on an empty square of the bitboards and mailbox.
+     * 
+     * @param piece - piece to place
+     * @param sq - square index to place it on
+     */
+    void putPiece(Piece piece, int sq);
+
+    /**
+     * @brief Removes the piece on a square from the bitboards and mailbox.
+     * 
+     * @param sq - square index of the piece to remove
+     */
+    void removePiece(int sq);
+
+    /**
+     * @brief Moves the piece on from to the empty square to in the bitboards and mailbox.
+     * 
+     * @param from - square index the piece is on
+     * @param to - square index the piece moves to
+     */
+    void movePiece(int from, int to);
+
+    /**
+     * @brief Adds a move from the square from to every square in targets. Moves onto an
+     * occupied square are flagged as captures.
+     * 
+     * @param from - starting square index of the moves
+     * @param targets - squares the piece moves to
+     * @param moves - list the moves are added to
+     */
+    void addMovesTo(int from, Bitboard targets, MoveList& moves);
+
+    /*
+    Per piece type move generation, dispatched by generatePieceMoves and generateMoves. Each adds the 
+    moves of the piece on sq that end on a square in targets, without considering checks or pins; 
+    generateMoves narrows targets to the legal squares.
+    */
+    void generateKnightMoves(int sq, Bitboard targets, MoveList& moves);
+    void generateBishopMoves(int sq, Bitboard targets, MoveList& moves);
+    void generateRookMoves(int sq, Bitboard targets, MoveList& moves);
+    void generateQueenMoves(int sq, Bitboard targets, MoveList& moves);
+
+    /**
+     * @brief Adds the pushes, captures and promotions of all pawns in the set at once, shifting the whole set
+     * one rank or diagonal instead of visiting each pawn. Only moves ending on a square in targets are added,
+     * without considering checks or pins. Does not include en passant.
+     * 
+     * @tparam Us - color of the pawns
+     * @tparam Type - GEN_CAPTURES adds captures and promotions, GEN_QUIETS the other pushes, GEN_ALL both
+     * @param pawns - squares of the pawns to move
+     * @param targets - squares the pawns may move to
+     * @param moves - list the moves are added to
+     */
+    template<Color Us, GenType Type>
+    void generatePawnMoves(Bitboard pawns, Bitboard targets, MoveList& moves);
+
+    /**
+     * @brief Adds the king moves of the king on sq, including castling, without checking the squares it moves to.
+     * 
+     * @param sq - square index of the king
+     * @param moves - list the moves are added to
+     */
+    void generateKingMoves(int sq, MoveList& moves);
+
+    /**
+     * @brief Finds the pieces of color c pinned to their king: the only piece between the king and an enemy slider
+     * on the same line.
+     * 
+     * @tparam Us - color of the king and the pinned pieces
+     * @return Bitboard - squares of the pinned pieces
+     */
+    template<Color Us>
+    Bitboard pinnedPieces() const;
+
+    /**
+     * @brief isAttacked for an attacking color known at compile time.
+     * 
+     * @tparam Them - color of the attacking pieces
+     * @param sq - square index to test
+     * @return true if a piece of color Them attacks sq
+     */
+    template<Color Them>
+    bool isAttackedBy(int sq) const;
+
+    /**
+     * @brief One step of static exchange evaluation: takes the least valuable piece of color stm among the attackers
+     * of sq off occupied, and adds the sliders it uncovered to attackers.
+     * 
+     * @param sq - square the exchange is on
+     * @param stmAttackers - attackers of color stm, not empty
+     * @param stm - color recapturing
+     * @param occupied - pieces still on the board, updated
+     * @param attackers - pieces of both colors attacking sq, updated
+     * @return PieceType - type of the piece taken off
+     */
+    PieceType popLeastValuableAttacker(int sq, Bitboard stmAttackers, Color stm, Bitboard& occupied,
+        Bitboard& attackers) const;
+
+    /**
+     * @brief Adds the castling moves of the king on sq. The squares between the king and rook must be empty, and
+     * the squares the king crosses must not be under attack. Does not check whether the king is in check.
+     * 
+     * @tparam Us - color of the castling king, which stands on its starting square when it has a castling right
+     * @param moves - list the moves are added to
+     */
+    template<Color Us>
+    void generateCastlingMoves(MoveList& moves);
+
+    /*
+    Per color bodies of generateMoves, makeMove and unmakeMove. Us is the side to move, for undoMove the
+    side that made the move being taken back. The public functions dispatch on whiteToPlay, so each is
+    instantiated once per color and the pawn direction, home ranks and castling squares are constants.
+    */
+    template<Color Us, GenType Type>
+    void generateLegalMoves(MoveList& moves);
+    template<Color Us>
+    void doMove(Move move);
+    template<Color Us>
+    void undoMove(Move move);
+
 
 public:
 
@@ -97,18 +269,33 @@ public:
     Board& operator=(Board other);
 
     /*
-    Equality operator overloading
+    Equality operator overloading. Boards are equal if they have the same position, game state and
+    move counts. Comparing the Zobrist keys first makes unequal boards cheap to tell apart
     */
     bool operator==(const Board& other);
     bool operator!=(const Board& other);
 
+    /*
+    One rank of the board, returned by operator[] so board[rank][file] gives the Square there. 
+    It reads the mailbox directly and is only valid while the board exists.
+    */
+    class RankView {
+        private:
+            const Piece* pieces;
+            int rank;
+
+        public:
+            RankView(const Piece* pieces, int rank) : pieces(pieces), rank(rank) {}
+            Square operator[](int file) const { return Square(rank, file, pieces[file]); }
+    };
+
     /**
      * @brief Overloading access operator [] for integer indexing
      * 
      * @param idx - rank to get
-     * @return std::vector<Square>& - gets the rank of idx
+     * @return RankView - the rank of idx, indexed by file
      */
-    std::vector<Square>& operator[](int idx);
+    RankView operator[](int idx) const { return RankView(mailbox + idx * 8, idx); }
     
     // BOARD INITIALIZATION
 
@@ -129,7 +316,7 @@ public:
     std::string toFEN();
 
     /**
-     * @brief Sets all squares to have an empty (nullptr) piece.
+     * @brief Empties every square and clears the bitboards.
      * 
      */
     void clearBoard();
@@ -141,7 +328,7 @@ public:
     void print();
 
     /**
-     * @brief Returns the 8x8 board vector of this position
+     * @brief Builds an 8x8 board vector of this position
      * 
      * @return std::vector<std::vector<Square> > - 8x8 array of the squares and corresponding pieces
      */
@@ -151,9 +338,70 @@ public:
      * @brief Get the Square object at loc. This is used in conjuction with the overloaded [] operator.
      * 
      * @param loc - tuple holding coordinates of desired Square
-     * @return Square& - reference to Square at loc
+     * @return Square - Square at loc holding its piece
+     */
+    Square getSquare(std::tuple<int, int> loc);
+
+    /**
+     * @brief Returns the piece on a square from the mailbox.
+     * 
+     * @param sq - square index, see squareIndex(rank, file)
+     * @return Piece - piece on the square, NO_PIECE if empty
+     */
+    Piece getPieceAt(int sq) const { return mailbox[sq]; }
+
+    /**
+     * @brief Returns the bitboard of all pieces of one color and type.
+     * 
+     * @param c - color of the pieces
+     * @param pt - type of the pieces
+     * @return Bitboard - squares holding those pieces
+     */
+    Bitboard getBitboard(Color c, PieceType pt) const { return pieceBB[c][pt]; }
+
+    /**
+     * @brief Returns the bitboard of all pieces of one color.
+     * 
+     * @param c - color of the pieces
+     * @return Bitboard - squares holding pieces of that color
+     */
+    Bitboard getColorBitboard(Color c) const { return colorBB[c]; }
+
+    /**
+     * @brief Returns the bitboard of all occupied squares.
+     * 
+     * @return Bitboard - squares holding any piece
+     */
+    Bitboard getOccupied() const { return occupiedBB; }
+
+    /**
+     * @brief Returns the Zobrist key of the position. Two boards with the same pieces, active color, castling rights
+     * and en passant target have the same key.
+     * 
+     * @return Key - 64 bit hash of the position
+     */
+    Key getKey() const { return key; }
+
+    /**
+     * @brief Middlegame and endgame piece-square table sums of the position, material included, from white's point
+     * of view. Updated incrementally by makeMove and unmakeMove.
      */
-    Square& getSquare(std::tuple<int, int> loc);
+    int getMidgameScore() const { return psqMidgame; }
+    int getEndgameScore() const { return psqEndgame; }
+
+    /**
+     * @brief Game phase: the PhaseWeight of every piece on the board added up, MAX_PHASE in the starting position.
+     * Promotions can take it above MAX_PHASE.
+     */
+    int getPhase() const { return phase; }
+
+    /**
+     * @brief Hashes the position from scratch. Slower than getKey, used to set the key when a FEN is loaded
+     * and to check the incremental updates.
+     * 
+     * @return Key - 64 bit hash of the position
+     */
+    Key computeKey() const;
 
 
     // GETTERS FOR GAMEPLAY //
@@ -164,7 +412,7 @@ public:
      * @return true - white is to play
      * @return false - black is to play
      */
-    bool getWhiteToPlay();
+    bool getWhiteToPlay() const;
 
     /**
      * @brief Get the half move count. This is a value that represents the number of turns that have been played
@@ -172,7 +420,7 @@ public:
      * 
      * @return int - moves since a pawn move or capture
      */
-    int getHalfMove();
+    int getHalfMove() const;
 
     /**
      * @brief Get the move number. Increments after black has played a move
@@ -196,29 +444,106 @@ public:
      */
     std::string getEnPassantTargets();
 
+    /**
+     * @brief Gets the en passant target square as a square index.
+     * 
+     * @return int - square index of the en passant target, -1 if en passant is not possible
+     */
+    int getEnPassantSquare() const { return enPassantSquare; }
+
     // MOVE GENERATION METHODS //
 
+    /**
+     * @brief Adds the moves of the piece on sq to moves, regardless of checks/pins. The piece type picks the 
+     * generator, and the piece color (not the color to play) decides which pieces it can capture.
+     * 
+     * @param sq - square index of the piece, see squareIndex(rank, file)
+     * @param moves - list the moves are added to
+     */
+    void generatePieceMoves(int sq, MoveList& moves);
+
+    /**
+     * @brief Adds the attacking moves of the piece on sq to moves. For pawns these are both diagonal moves, whether or not
+     * a piece stands there. Kings do not include castling. For all other pieces they are the same as generatePieceMoves.
+     * 
+     * @param sq - square index of the piece, see squareIndex(rank, file)
+     * @param moves - list the moves are added to
+     */
+    void generatePieceAttackingMoves(int sq, MoveList& moves);
+
     /**
      * @brief Generates all attacking moves. For pawns, this includes diagonal attacking moves
-     * that do not attack antything. For all other pieces, it returns the possible moves for that piece. 
+     * that do not attack antything. Kings do not include castling. For all other pieces, it returns the possible moves for that piece. 
      * 
-     * @return std::vector<Move> - moves that attack squares.
+     * @param moves - filled with the moves that attack squares. Any moves already in the list are removed
      */
-    std::vector<Move> getAttackingMoves();
+    void getAttackingMoves(MoveList& moves);
 
     /**
      * @brief Generates all moves on the board for the color to play regardless of checks/pins.
      * 
+     * @param moves - filled with the moves. Any moves already in the list are removed
+     */
+    void generateAllMoves(MoveList& moves);
+
+    /**
+     * @brief Generates all legal moves on the board for the color to play. The checking pieces and pinned pieces are
+     * found once; each piece's moves are limited to the squares that capture or block a single check and to its pin
+     * line, king moves are tested against the opponent's attacks, and in double check only the king moves.
+     * 
+     * @param moves - filled with all legal moves in the current position. Any moves already in the list are removed
+     */
+    void generateMoves(MoveList& moves);
+
+    /**
+     * @brief Generates the legal captures, en passant captures and promotions for the color to play, the
+     * first generation stage of the search.
+     * 
+     * @param moves - filled with the moves. Any moves already in the list are removed
+     */
+    void generateCaptures(MoveList& moves);
+
+    /**
+     * @brief Generates the legal moves generateCaptures leaves out: quiet moves, double pawn pushes and castling.
+     * 
+     * @param moves - filled with the moves. Any moves already in the list are removed
+     */
+    void generateQuiets(MoveList& moves);
+
+    /**
+     * @brief Returns true if move is legal in the current position. Used to check moves that come from
+     * elsewhere than the generators, such as a hash move or a killer move, before they are played.
+     * 
+     * @param move - move to check
+     * @return true if the move is one generateMoves would produce
+     */
+    bool isLegal(Move move);
+
+    /**
+     * @brief Counts the leaf nodes of the legal move tree to a depth. Used to test move generation against known counts.
+     * 
+     * @param depth - number of plies to play
+     * @return uint64_t - number of move sequences of length depth
      */
-    std::vector<Move> generateAllMoves();
+    uint64_t perft(int depth);
 
     /**
-     * @brief Generates all valid moves on the board for the color to play.
-     * Does not yet account for checks, pins, etc. 
+     * @brief Finds the enemy pieces giving check to the king of the color to play.
      * 
-     * @return std::vector<Move> - all possible moves in the current position
+     * @return Bitboard - squares of the checking pieces, empty if not in check
+     */
+    Bitboard getCheckers() const;
+
+    /**
+     * @brief Returns true if the king of the color to play is in check.
      */
-    std::vector<Move> generateMoves();
+    bool inCheck() const;
+
+    /**
+     * @brief Returns true if the current position occurred before in the moves played with makeMove. Only the
+     * positions since the last capture or pawn move are compared, no earlier position can repeat.
+     */
+    bool isRepetition() const;
 
     /**
      * @brief Finds all pins and checks in the current position. A pin is a piece that if moved would result in the 
@@ -231,29 +556,111 @@ public:
     std::tuple<bool, std::vector<Pin>, std::vector<Check> > getPinsAndChecks();
 
     /**
-     * @brief Determines if a square is under attack by an enemy piece. If an enemy piece's move ends on this square,
-     * the squre is under attack.
+     * @brief Determines if a square is under attack by a piece of the color not to play. Same as 
+     * isAttacked(square, opponent).
      * 
      * @param square - Square object that could be under attack
      * @return true - if the square is under attack
      * @return false - if the square is not under attack
      */
-    bool squareUnderAttack(Square& square);
+    bool squareUnderAttack(const Square& square);
 
     /**
-     * @brief Makes a move on the board. The Move object stores the starting and ending square as well as the piece moved and 
-     * piece captured, if valid. May also contain if the move is a castling move or en passant move.
-     * This method sets the starting square of the move empty, and sets the ending square of the move to the piece moved.
-     * Has functionality of playing a castling move.
+     * @brief Finds every piece of either color attacking a square, looked up from the square outwards with the attack
+     * tables. Sliders are blocked by the squares in occupied, so passing a board with pieces removed finds x-ray attackers.
      * 
-     * TODO - implement en passant moves
+     * @param sq - square index of the attacked square
+     * @param occupied - squares that block sliders, usually getOccupied()
+     * @return Bitboard - squares of the pieces attacking sq
+     */
+    Bitboard attackersTo(int sq, Bitboard occupied) const;
+
+    /**
+     * @brief Finds the pieces of one color attacking a square. Does not change the board.
+     * 
+     * @param sq - square index of the attacked square
+     * @param c - color of the attacking pieces
+     * @return Bitboard - squares of the pieces of color c attacking sq
+     */
+    Bitboard attackersTo(int sq, Color c) const;
+
+    /**
+     * @brief Determines if any piece of one color attacks a square. Faster than attackersTo as it stops at the first 
+     * attacker type found. The square may hold a piece of either color.
+     * 
+     * @param sq - square index of the attacked square
+     * @param c - color of the attacking pieces
+     * @return true - if a piece of color c attacks sq
+     * @return false - if no piece of color c attacks sq
+     */
+    bool isAttacked(int sq, Color c) const;
+
+    /**
+     * @brief Static exchange evaluation: returns true if the capture sequence move starts on its ending square wins
+     * at least threshold centipawns for the side making it, with both sides recapturing with their least valuable
+     * attacker and free to stop whenever recapturing loses. Sliders behind pieces that leave the square join in as
+     * they are uncovered. A promotion wins the promoted piece less the pawn, and pawns recapturing on the last
+     * rank promote to queens. Nothing is played on the board. Castling counts as winning nothing.
+     * 
+     * @param move - move of the side to play
+     * @param threshold - material gain to test for, in centipawns
+     * @return true if the exchange gains at least threshold
+     */
+    bool seeGE(Move move, int threshold) const;
+
+    /**
+     * @brief Static exchange evaluation: the material the side making move wins, in centipawns, over the capture
+     * sequence on its ending square, with the same rules as seeGE. Negative if the move loses material. seeGE is
+     * cheaper when only a threshold matters, as it stops as soon as the outcome is known.
+     * 
+     * @param move - move of the side to play
+     * @return int - material balance of the exchange for the side making move
+     */
+    int see(Move move) const;
+
+    /**
+     * @brief Makes a move on the board. The Move object stores the starting and ending square and a flag for captures,
+     * castling, en passant, double pawn pushes and promotions. The pieces moved and captured are looked up on the board.
+     * This method sets the starting square of the move empty, and sets the ending square of the move to the piece moved.
+     * Has functionality of playing castling, en passant and promotion moves.
      * 
      * @param move - Move object to be played
      */
     void makeMove(Move move);
 
+    /**
+     * @brief Takes back the last move played with makeMove, restoring the position exactly as it was before it.
+     * The state makeMove can not recompute (captured piece, castling rights, en passant square and half move count)
+     * comes from the undo stack, so this does not copy the board or allocate.
+     * 
+     * @param move - the last Move played on this board
+     */
+    void unmakeMove(Move move);
+
+    /**
+     * @brief Passes the turn to the opponent without moving a piece, for null move pruning. The en passant target
+     * is cleared and the half move count restarts, so repetitions are not detected across a null move. Must not be
+     * played when the side to move is in check.
+     */
+    void makeNullMove();
+
+    /**
+     * @brief Takes back the null move played last with makeNullMove.
+     */
+    void unmakeNullMove();
+
 };
 
+/**
+ * @brief Algebraic notation of a move in a position, for instance "Nf3", "exd5", "e8=Q" or "O-O".
+ * The piece moved is looked up on the board, so the move must not have been played yet.
+ * 
+ * @param board - position the move is played in
+ * @param move - move to format
+ * @return std::string - algebraic notation of the move
+ */
+std::string moveToAlgebraic(Board& board, Move move);
+
 
 
 #endif
\ No newline at end of file
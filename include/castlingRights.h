@@ -21,6 +21,14 @@ class CastlingRights {
         CastlingRights& operator=(CastlingRights other);
 
         std::string toString();
+
+        /**
+         * @brief Packs the rights into 4 bits: 1 white kingside, 2 white queenside, 4 black kingside, 8 black queenside.
+         * Used to index the castling Zobrist keys.
+         * 
+         * @return int - castling rights as a bitmask from 0 to 15
+         */
+        int toMask() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,16 @@
+#ifndef EVALUATE_H
+#define EVALUATE_H
+
+#include "board.h"
+
+/**
+ * @brief Static evaluation of the position, from the point of view of the color to play: positive
+ * when the side to move is ahead. Material and piece-square tables, tapered from the middlegame to the
+ * endgame scores by the game phase. Constant time: the board keeps the sums up to date.
+ * 
+ * @param board - position to evaluate
+ * @return int - score in centipawns
+ */
+int evaluate(const Board& board);
+
+#endif
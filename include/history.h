@@ -0,0 +1,80 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "move.h"
+#include "types.h"
+
+// History scores stay within [-MAX_HISTORY, MAX_HISTORY]
+const int MAX_HISTORY = 16384;
+
+/*
+Statistics a search thread gathers about quiet moves to order them: how often a move has caused a beta
+cutoff, by the color moving and its squares (butterfly table) and by the piece moved and its destination
+(piece-to table), and which move last refuted each move of the opponent (countermove table). Each Search
+owns one, so the tables are written without synchronisation.
+
+Updates use gravity: a bonus shrinks as the score nears MAX_HISTORY, so scores stay bounded and recent
+cutoffs weigh more than old ones.
+*/
+class History {
+
+    private:
+        int butterfly[2][64][64];
+        int pieceTo[12][64];
+        Move counterMoves[12][64];
+
+        /**
+         * @brief Adds bonus to a history score, scaled down as the score approaches MAX_HISTORY.
+         */
+        static void applyBonus(int& score, int bonus);
+
+    public:
+        History();
+
+        /**
+         * @brief Resets every score to zero and forgets the countermoves.
+         */
+        void clear();
+
+        /**
+         * @brief Ordering score of a quiet move, higher is searched first.
+         * 
+         * @param piece - piece making the move
+         * @param move - quiet move
+         * @return int - sum of the butterfly and piece-to scores
+         */
+        int score(Piece piece, Move move) const;
+
+        /**
+         * @brief Rewards a quiet move that caused a beta cutoff, or punishes one searched before it.
+         * 
+         * @param piece - piece making the move
+         * @param move - quiet move
+         * @param bonus - positive to reward, negative to punish, at most MAX_HISTORY in size
+         */
+        void update(Piece piece, Move move, int bonus);
+
+        /**
+         * @brief Returns the move that last refuted the opponent's move, or a null Move.
+         * 
+         * @param piece - piece the opponent moved, as it stands on its destination
+         * @param to - destination square of the opponent's move
+         */
+        Move getCounterMove(Piece piece, int to) const { return counterMoves[piece][to]; }
+
+        /**
+         * @brief Records move as the refutation of the opponent's move.
+         * 
+         * @param piece - piece the opponent moved, as it stands on its destination
+         * @param to - destination square of the opponent's move
+         * @param move - quiet move that caused the cutoff
+         */
+        void setCounterMove(Piece piece, int to, Move move) { counterMoves[piece][to] = move; }
+
+        /**
+         * @brief Bonus for a cutoff at the given remaining depth: deeper cutoffs save more work.
+         */
+        static int bonus(int depth);
+};
+
+#endif
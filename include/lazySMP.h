@@ -0,0 +1,74 @@
+#ifndef LAZYSMP_H
+#define LAZYSMP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "board.h"
+#include "search.h"
+#include "transpositionTable.h"
+
+/*
+Multithreaded search by Lazy SMP. Every thread runs an ordinary iterative deepening Search of the same
+root on its own copy of the Board, with its own PV table and move lists. The threads only share the
+transposition table, through which they pick up each other's results. Helper threads skew their
+iteration depths (see Search), so they explore positions the main thread reaches later.
+
+The main thread's limits decide the search. Once it finishes, the helpers are told to stop, and the
+main thread's result is returned with the nodes of all threads added up. When the main thread's hard
+time limit runs out it raises the shared stop signal itself, which every thread checks at every node.
+*/
+class LazySMP {
+
+    private:
+        TranspositionTable tt;
+        int threadCount;
+        SearchOptions options;
+        std::atomic<bool> stopSignal;
+
+    public:
+        /**
+         * @brief Construct a LazySMP search.
+         * 
+         * @param threads - number of search threads, including the main thread
+         * @param hashMegabytes - size of the shared transposition table
+         */
+        LazySMP(int threads = 1, size_t hashMegabytes = 16);
+
+        /**
+         * @brief Sets the number of search threads used by the next search, at least 1.
+         */
+        void setThreads(int threads);
+
+        int getThreads() const { return threadCount; }
+
+        /**
+         * @brief Resizes the shared transposition table, losing its entries. Must not be called during a search.
+         */
+        void setHashSize(size_t megabytes);
+
+        TranspositionTable& getTable() { return tt; }
+
+        /**
+         * @brief Switches the selective search techniques of every thread for the next search.
+         */
+        void setOptions(const SearchOptions& options) { this->options = options; }
+
+        /**
+         * @brief Searches the position on board with all threads. The board is not changed, each thread
+         * searches a copy.
+         * 
+         * @param board - position to search
+         * @param limits - limits of the main thread; helpers run until the main thread stops
+         * @return SearchResult - result of the main thread, nodes and table statistics counted over all threads
+         */
+        SearchResult run(const Board& board, const SearchLimits& limits);
+
+        /**
+         * @brief Stops a running search from another thread. run returns the deepest completed iteration.
+         */
+        void stop() { stopSignal.store(true, std::memory_order_relaxed); }
+};
+
+#endif
@@ -2,90 +2,153 @@
 #define MOVE_H
 
 
+#include <cstdint>
 #include <tuple>
-#include <map>
 #include <string>
 #include <iostream>
-
-// Forward declaration of BasePiece 
-class BasePiece;
+#include <type_traits>
+
+#include "types.h"
+
+/*
+Special move flags, stored in the top 4 bits of a Move. Bit 2 marks captures and bit 3 marks
+promotions; the low 2 bits of a promotion give the piece (knight, bishop, rook, queen).
+*/
+enum MoveFlag {
+    QUIET = 0,
+    DOUBLE_PAWN_PUSH = 1,
+    KING_CASTLE = 2,
+    QUEEN_CASTLE = 3,
+    CAPTURE = 4,
+    EN_PASSANT = 5,
+    KNIGHT_PROMOTION = 8,
+    BISHOP_PROMOTION = 9,
+    ROOK_PROMOTION = 10,
+    QUEEN_PROMOTION = 11,
+    KNIGHT_PROMOTION_CAPTURE = 12,
+    BISHOP_PROMOTION_CAPTURE = 13,
+    ROOK_PROMOTION_CAPTURE = 14,
+    QUEEN_PROMOTION_CAPTURE = 15
+};
 
 class Move {
 
     private:
-        int id;
-
-        
+        /**
+         * @brief The whole move packed into 16 bits:
+         *   bits 0-5   - starting square index
+         *   bits 6-11  - ending square index
+         *   bits 12-15 - MoveFlag
+         */
+        uint16_t data;
 
+    public:
         /**
-         * @brief Move id is used to generate a unique identifier for each move.
-         * The move id is in the format as follows:
-         *   Thousands place - t1[0]
-         *   Hundreds place  - t1[1]
-         *   Tens place      - t2[0]
-         *   Ones place      - t2[1]
-        */
-        int generateMoveID(std::tuple<int, int> t1, std::tuple<int, int> t2);
+         * @brief Construct the null move. It moves a8 to a8 and is never generated, so it is used
+         * to mean "no move".
+         */
+        Move() : data(0) {}
 
-    public:  
         /**
          * @brief Construct a new Move object
-         * 
+         *
+         * @param from - starting square index of the move
+         * @param to - ending square index of the move
+         * @param flag - MoveFlag of the move
+         */
+        Move(int from, int to, int flag = QUIET) : data(uint16_t(from | (to << 6) | (flag << 12))) {}
+
+        /**
+         * @brief Construct a new Move object from (rank, file) tuples
+         *
          * @param start - starting position of the move
          * @param end - ending position of the move
-         * @param pieceMoved - pointer to the piece that was moved
-         * @param pieceCaptured - pointer to the piece that was captured
-         * @param isCastle - value representing if the move is a castling move
+         * @param flag - MoveFlag of the move
          */
-        Move(std::tuple<int, int> start, std::tuple<int, int> end, BasePiece* pieceMoved, BasePiece* pieceCaptured = nullptr, bool isCastle = false);
-       
-        /*
-        Rule of Three implementation
-        */
-       ~Move();
-        Move(const Move& other);
-        Move& operator=(Move other);
+        Move(std::tuple<int, int> start, std::tuple<int, int> end, int flag = QUIET) :
+            Move(squareIndex(std::get<0>(start), std::get<1>(start)), squareIndex(std::get<0>(end), std::get<1>(end)), flag) {}
 
         /*
-        Equality operator overloading 
+        Equality operator overloading
         */
-        bool operator==(const Move other) const;
-        bool operator!=(const Move other) const;
+        bool operator==(const Move other) const { return data == other.data; }
+        bool operator!=(const Move other) const { return data != other.data; }
 
-        // Stores the piece that moved and the piece that was captured, if applicable
-        BasePiece* pieceMoved;
-        BasePiece* pieceCaptured;
+        // Starting and ending square indices of the move
+        int from() const { return data & 0x3F; }
+        int to() const { return (data >> 6) & 0x3F; }
 
-        // Starting and ending positions of the piece moved on the chessboard
-        std::tuple<int, int> start;
-        std::tuple<int, int> end;
+        // MoveFlag of the move
+        int flag() const { return data >> 12; }
 
-        // Castling and en passant rights
-        bool isCastleMove;
-        
-        // Maps for generating algebraic chess notation
-        std::map<int, int> rowsToRanks;
-        std::map<int, char> colsToFiles;
+        // Starting and ending positions as (rank, file) tuples
+        std::tuple<int, int> getStart() const { return std::make_tuple(rankOf(from()), fileOf(from())); }
+        std::tuple<int, int> getEnd() const { return std::make_tuple(rankOf(to()), fileOf(to())); }
 
-        /**
-         * @brief Returns the move id of this move.
-         * 
-         * @return int - id of the move
-        */
-        int getMoveID();
+        bool isNull() const { return data == 0; }
+        bool isCapture() const { return (flag() & CAPTURE) != 0; }
+        bool isPromotion() const { return (flag() & KNIGHT_PROMOTION) != 0; }
+        bool isCastle() const { return flag() == KING_CASTLE || flag() == QUEEN_CASTLE; }
+        bool isEnPassant() const { return flag() == EN_PASSANT; }
+        bool isDoublePawnPush() const { return flag() == DOUBLE_PAWN_PUSH; }
 
-        /** 
-         * @brief Used for generating the algebraic chess notation of this move.
-         * 
-         * @return std::string - algebraic notation of this move
-        */
-        std::string getRankFile(int row, int col);
+        /**
+         * @brief Piece type a pawn promotes to. Only meaningful if isPromotion() is true.
+         *
+         * @return PieceType - KNIGHT, BISHOP, ROOK or QUEEN
+         */
+        PieceType promotionType() const { return PieceType(KNIGHT + (flag() & 3)); }
 
         /**
-         * @brief Print the algebraic chess notation of this move
-        */
-        friend std::ostream& operator<<(std::ostream& os, const Move& move);
+         * @brief Returns the 16 bit encoding of this move.
+         *
+         * @return uint16_t - packed move
+         */
+        uint16_t raw() const { return data; }
 
 };
 
-#endif
\ No newline at end of file
+static_assert(sizeof(Move) == 2, "Move must pack into 16 bits");
+static_assert(std::is_trivially_copyable<Move>::value, "Move must be trivially copyable");
+
+
+/**
+ * @brief Algebraic name of a square, for instance (3, 3) is "d5".
+ *
+ * @param rank - rank of the square, 0 is the 8th rank
+ * @param file - file of the square, 0 is the a file
+ * @return std::string - algebraic name of the square
+*/
+std::string squareName(int rank, int file);
+
+/**
+ * @brief Algebraic name of a square index.
+ *
+ * @param sq - square index, see squareIndex
+ * @return std::string - algebraic name of the square
+*/
+std::string squareName(int sq);
+
+/**
+ * @brief Parses an algebraic square name such as "e3".
+ *
+ * @param name - algebraic square name
+ * @return int - square index, -1 if name is not a square (for instance "-")
+ */
+int squareFromName(const std::string& name);
+
+/**
+ * @brief Coordinate notation of a move: starting and ending square, plus the promotion piece,
+ * for instance "e2e4" or "e7e8q".
+ *
+ * @param move - move to format
+ * @return std::string - coordinate notation of the move
+ */
+std::string moveToString(Move move);
+
+/**
+ * @brief Prints the coordinate notation of a move
+ */
+std::ostream& operator<<(std::ostream& os, const Move& move);
+
+#endif
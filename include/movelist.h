@@ -0,0 +1,88 @@
+#ifndef MOVELIST_H
+#define MOVELIST_H
+
+#include <algorithm>
+#include <cassert>
+
+#include "move.h"
+
+// No legal chess position has more than 218 moves, so 256 entries always suffice
+const int MAX_MOVES = 256;
+
+/*
+Fixed-capacity list of moves stored inline, used in place of std::vector<Move> by the move
+generators. A MoveList never allocates: it is declared on the stack and filled through a
+reference by the generators, so making one per search node costs nothing.
+*/
+class MoveList {
+
+    private:
+        Move moves[MAX_MOVES];
+        int count;
+
+    public:
+        /**
+         * @brief Construct an empty MoveList
+         */
+        MoveList() : count(0) {}
+
+        /**
+         * @brief Adds a move to the end of the list
+         *
+         * @param move - move to add
+         */
+        void push_back(Move move) {
+            assert(count < MAX_MOVES);
+            moves[count++] = move;
+        }
+
+        /**
+         * @brief Removes the move at idx by moving the last move into its slot. The order of the
+         * remaining moves is not kept, so iterate backwards when erasing in a loop.
+         *
+         * @param idx - index of the move to remove
+         */
+        void erase(int idx) {
+            moves[idx] = moves[--count];
+        }
+
+        // Removes all moves from the list
+        void clear() { count = 0; }
+
+        int size() const { return count; }
+        bool empty() const { return count == 0; }
+
+        Move& operator[](int idx) { return moves[idx]; }
+        const Move& operator[](int idx) const { return moves[idx]; }
+
+        /*
+        Iterators, so a MoveList works with range based for loops and the <algorithm> functions
+        */
+        Move* begin() { return moves; }
+        Move* end() { return moves + count; }
+        const Move* begin() const { return moves; }
+        const Move* end() const { return moves + count; }
+
+        /**
+         * @brief Returns true if move is in the list
+         *
+         * @param move - move to look for
+         */
+        bool contains(Move move) const {
+            return std::find(begin(), end(), move) != end();
+        }
+
+        /**
+         * @brief Sorts the moves with a comparison function, used for move ordering. comp(a, b)
+         * returns true if a should be searched before b.
+         *
+         * @param comp - comparison function of two moves
+         */
+        template<typename Compare>
+        void sort(Compare comp) {
+            std::sort(begin(), end(), comp);
+        }
+
+};
+
+#endif
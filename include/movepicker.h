@@ -0,0 +1,108 @@
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+
+#include "board.h"
+#include "history.h"
+#include "move.h"
+#include "movelist.h"
+
+// Stages of a MovePicker, in the order the moves are returned
+enum PickerStage {
+    HASH_MOVE,
+    GENERATE_CAPTURES,
+    CAPTURES,
+    REFUTATIONS,
+    GENERATE_QUIETS,
+    QUIETS,
+    BAD_CAPTURES,
+    DONE
+};
+
+/*
+Hands out the legal moves of a position one at a time, generating them lazily in stages: the hash
+move first, then the captures and promotions ordered by MVV-LVA (most valuable victim, least valuable
+attacker), then the killer moves and the countermove, then the quiet moves ordered by their history
+scores. A stage is only generated when the previous one runs out, so a search node that cuts off on an
+early move never generates its quiet moves.
+Captures that lose material by static exchange evaluation are held back and returned last.
+The quiescence search uses a picker that stops after the captures and drops the losing ones.
+
+The board must be in the same position on every call to next. Moves played in between must be taken
+back with unmakeMove first.
+*/
+class MovePicker {
+
+    private:
+        Board& board;
+        Move hashMove;
+        bool capturesOnly;
+
+        // Quiet moves likely to cut off, searched before the other quiets: the two killers and the countermove
+        Move refutations[3];
+
+        // History scores ordering the quiet moves, null to leave them in generation order
+        const History* history;
+
+        PickerStage stage;
+        MoveList moves;
+        int scores[MAX_MOVES];
+        int current;
+
+        // Captures losing material, in the order they were picked
+        MoveList badCaptures;
+
+        /**
+         * @brief Ordering score of a capture or promotion, higher is searched first
+         */
+        int captureScore(Move move) const;
+
+        /**
+         * @brief Returns the highest scored move not yet returned, moving it to the front of the remaining
+         * moves. A selection sort one step at a time, so moves after a cutoff are never sorted.
+         */
+        Move pickBest();
+
+        /**
+         * @brief Returns true if refutation i is a legal quiet move in this position, not returned before.
+         */
+        bool isValidRefutation(int i) const;
+
+        /**
+         * @brief Returns true if move was already returned by the hash move or refutation stage.
+         */
+        bool alreadyReturned(Move move) const;
+
+    public:
+        /**
+         * @brief Construct a MovePicker for the position on board.
+         *
+         * @param board - board holding the position, must outlive the MovePicker
+         * @param hashMove - best move stored for this position, or a null Move. Skipped if it is not legal
+         * @param killer1 - quiet move that caused a cutoff at the same ply in a sibling node, or a null Move.
+         * Killers and the countermove are skipped if they are not legal quiet moves here
+         * @param killer2 - second killer move, or a null Move
+         * @param counterMove - quiet move that last refuted the opponent's previous move, or a null Move
+         * @param history - history scores of the searching thread, or null to leave the quiet moves unordered.
+         * Must outlive the MovePicker
+         */
+        MovePicker(Board& board, Move hashMove = Move(), Move killer1 = Move(), Move killer2 = Move(),
+            Move counterMove = Move(), const History* history = nullptr);
+
+        /**
+         * @brief Construct a MovePicker returning only the captures and promotions that do not lose material,
+         * for the quiescence search.
+         *
+         * @param board - board holding the position, must outlive the MovePicker
+         * @param capturesOnly - true to stop after the captures, false to pick every move as the constructor above
+         */
+        MovePicker(Board& board, bool capturesOnly);
+
+        /**
+         * @brief Returns the next move, generating the next stage if the current one is used up.
+         *
+         * @return Move - next legal move, a null Move once all moves have been returned
+         */
+        Move next();
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef PSQT_H
+#define PSQT_H
+
+#include "types.h"
+
+/*
+Piece-square tables: what each piece is worth on each square, including its material value, once for the
+middlegame and once for the endgame. Black's entries are white's mirrored top to bottom and negated, so
+adding up the entries of every piece on the board gives a score from white's point of view.
+
+The Board keeps these sums up to date as pieces are put, removed and moved, together with the game phase,
+so the evaluation does not scan the board.
+*/
+extern int PsqMidgame[12][64];
+extern int PsqEndgame[12][64];
+
+// Game phase weight of each piece type. The starting position has MAX_PHASE, bare kings zero
+const int PhaseWeight[6] = { 0, 1, 1, 2, 4, 0 };
+const int MAX_PHASE = 24;
+
+/**
+ * @brief Fills the piece-square tables on the first call. Called by the Board, like initZobrist.
+ */
+void initPSQT();
+
+#endif
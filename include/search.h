@@ -0,0 +1,241 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "board.h"
+#include "history.h"
+#include "move.h"
+#include "timeManager.h"
+#include "transpositionTable.h"
+
+// Deepest ply the search reaches, from the root
+const int MAX_PLY = 128;
+
+/*
+Search scores are in centipawns from the point of view of the side to move. Being mated n plies from the
+root scores -VALUE_MATE + n, so shorter mates score further from zero. Any score beyond VALUE_MATE_IN_MAX_PLY
+is a mate score.
+*/
+const int VALUE_DRAW = 0;
+const int VALUE_MATE = 32000;
+const int VALUE_INFINITE = 32001;
+const int VALUE_MATE_IN_MAX_PLY = VALUE_MATE - MAX_PLY;
+
+/*
+When a search stops. Zero means no limit; a search with no limit set runs to MAX_PLY. Times are in
+milliseconds of wall clock, see TimeManager.
+*/
+struct SearchLimits {
+    int depth;          // deepest iteration to complete
+    uint64_t nodes;     // nodes to visit at most, the iteration running out of nodes is thrown away
+    int64_t movetime;   // time for this move, used in full
+    int64_t wtime;      // time left on white's clock
+    int64_t btime;      // time left on black's clock
+    int64_t winc;       // white's increment per move
+    int64_t binc;       // black's increment per move
+    int movestogo;      // moves until the next time control, 0 if the clock covers the rest of the game
+
+    SearchLimits() : depth(0), nodes(0), movetime(0), wtime(0), btime(0), winc(0), binc(0), movestogo(0) {}
+};
+
+/*
+Selective search techniques, each switched on or off at runtime so their effect can be measured. All are on by
+default. The pruning techniques only act in nodes searched with a null window, outside the principal variation.
+Late move reductions also reduce late quiet moves in PV nodes, by one ply less and never the second move. None
+of them act when the side to move is in check.
+*/
+struct SearchOptions {
+    bool nullMove;              // give the opponent a free move: if we still beat beta, cut off at reduced depth
+    bool lateMoveReductions;    // search quiet moves late in the ordering to a reduced depth first
+    bool futility;              // skip quiet moves near the leaves that cannot lift the static evaluation to alpha
+    bool reverseFutility;       // cut off near the leaves when the static evaluation beats beta by a margin
+    bool razoring;              // drop to the quiescence search near the leaves when far below alpha
+
+    SearchOptions() : nullMove(true), lateMoveReductions(true), futility(true), reverseFutility(true), razoring(true) {}
+};
+
+/*
+How often the search had to search a move or the root again because a narrowed window was wrong, and where
+the hard time limit stopped it.
+*/
+struct SearchStats {
+    uint64_t pvsResearches;         // null window searches that raised alpha and were searched with the full window
+    uint64_t lmrResearches;         // reduced searches that raised alpha and were searched at full depth
+    uint64_t aspirationFailLows;    // root searches that scored at or below the aspiration window
+    uint64_t aspirationFailHighs;   // root searches that scored at or above the aspiration window
+    uint64_t hardLimitNodes;        // node count at the clock check that found the hard limit passed, 0 if none did
+
+    SearchStats() : pvsResearches(0), lmrResearches(0), aspirationFailLows(0), aspirationFailHighs(0), hardLimitNodes(0) {}
+};
+
+/*
+Outcome of a search: the result of the deepest iteration that completed.
+*/
+struct SearchResult {
+    Move bestMove;          // null if the side to move has no legal move, or no iteration completed
+    int score;              // score of bestMove, see VALUE_MATE
+    int depth;              // depth of the last completed iteration
+    uint64_t nodes;         // nodes visited over all iterations
+    std::vector<Move> pv;   // principal variation, starting with bestMove
+    SearchStats stats;      // re-searches over all iterations
+    TTStats tableStats;     // transposition table probes, hits and collisions over all iterations
+
+    SearchResult() : score(0), depth(0), nodes(0) {}
+};
+
+/*
+Negamax alpha-beta search with iterative deepening. The search plays its moves on the given board with
+makeMove and unmakeMove, so no boards are copied, and leaves the board as it found it. The principal
+variation is collected in a triangular table: row ply holds the best line found from ply on.
+
+The first move of a node is searched with the full window and the others with a null window around alpha,
+to prove they are worse (principal variation search); a move that turns out better is searched again with
+the full window. From the fifth iteration on, the root is searched with an aspiration window around the
+score of the previous iteration, widened and searched again when the score falls outside it.
+
+Searched positions are stored in a transposition table, so each iteration starts from the moves and
+bounds of the one before. The table can be shared by several Searches running at once, each on its own
+Board, see LazySMP. Helper threads (threadId above 0) skip some iteration depths so that the threads
+spread over different depths instead of repeating each other's work.
+
+Quiet moves are ordered by statistics gathered from the beta cutoffs of the search: two killer moves per
+ply, and the history and countermove tables. Each Search keeps its own, cleared at the start of run.
+*/
+class Search {
+
+    private:
+        Board& board;
+        std::unique_ptr<TranspositionTable> ownTable;
+        TranspositionTable& tt;
+        SearchLimits limits;
+        SearchOptions options;
+        SearchStats stats;
+        TTStats tableStats;
+        TimeManager timeManager;
+        uint64_t nodes;
+        bool stopped;
+
+        // Shared by the threads of a search, checked at every node. Set by another thread to stop the search, and
+        // by this one when its time runs out, so that all threads stop at once. May be null
+        std::atomic<bool>* stopSignal;
+        int threadId;
+
+        // Best move of the previous iteration, searched first at the root
+        Move rootBestMove;
+
+        Move pvTable[MAX_PLY][MAX_PLY];
+        int pvLength[MAX_PLY];
+
+        // Move being searched at each ply, to find the countermove of the opponent's last move. Null after a null move
+        Move currentMove[MAX_PLY];
+
+        // Two most recent quiet moves that caused a beta cutoff at each ply
+        Move killers[MAX_PLY][2];
+        History history;
+
+        /**
+         * @brief Searches the position on the board to the given depth.
+         * 
+         * @param depth - remaining depth in plies, the quiescence search takes over at zero
+         * @param ply - distance from the root
+         * @param alpha - score the side to move is already guaranteed
+         * @param beta - score the opponent is already guaranteed, a move reaching it cuts the search off
+         * @return int - score of the position, fail soft: may lie outside alpha and beta
+         */
+        int negamax(int depth, int ply, int alpha, int beta);
+
+        /**
+         * @brief Searches only the captures and promotions of the position, until it is quiet, so that the score
+         * of a leaf is never taken in the middle of an exchange. The side to move may stand pat on the static
+         * evaluation instead of capturing, and captures that lose material by static exchange evaluation are
+         * skipped. In check every evasion is searched.
+         * 
+         * @param ply - distance from the root
+         * @param alpha - score the side to move is already guaranteed
+         * @param beta - score the opponent is already guaranteed, a move reaching it cuts the search off
+         * @return int - score of the position, fail soft: may lie outside alpha and beta
+         */
+        int quiescence(int ply, int alpha, int beta);
+
+        /**
+         * @brief Rewards the quiet move that caused a beta cutoff: it becomes the first killer of its ply and the
+         * countermove of the previous move, and its history score rises while the quiet moves searched before it
+         * fall.
+         * 
+         * @param ply - distance from the root
+         * @param depth - remaining depth of the node
+         * @param move - quiet move that caused the cutoff
+         * @param quiets - quiet moves searched before move without a cutoff
+         * @param quietCount - number of moves in quiets
+         */
+        void updateQuietStats(int ply, int depth, Move move, const Move* quiets, int quietCount);
+
+        /**
+         * @brief Checks the stop signal and the node and time limits. Called once per node; the clock is only
+         * read every 1024 nodes.
+         * 
+         * @return true if the search must stop now
+         */
+        bool shouldStop();
+
+        /**
+         * @brief Copies the line below ply into row ply of the PV table, behind move.
+         */
+        void updatePV(int ply, Move move);
+
+    public:
+        /**
+         * @brief Construct a Search on a board with a transposition table of its own, aged by every call to run.
+         * 
+         * @param board - position to search, must outlive the Search
+         */
+        Search(Board& board);
+
+        /**
+         * @brief Construct a Search on a board sharing a transposition table. The owner of the table calls
+         * newSearch on it before each search.
+         * 
+         * @param board - position to search, must outlive the Search
+         * @param tt - transposition table, must outlive the Search
+         * @param stopSignal - flag shared by the threads of the search, set by any of them to stop all, or null
+         * @param threadId - 0 for the main thread, which searches every depth, above 0 for helper threads
+         */
+        Search(Board& board, TranspositionTable& tt, std::atomic<bool>* stopSignal = nullptr, int threadId = 0);
+
+        /**
+         * @brief Searches the position with iterative deepening until a limit is reached. With a time budget, no
+         * iteration starts after the soft limit of the TimeManager and the search stops at its hard limit.
+         * 
+         * @param limits - depth, node and time limits of the search
+         * @return SearchResult - best move, score and principal variation of the deepest completed iteration
+         */
+        SearchResult run(const SearchLimits& limits);
+
+        /**
+         * @brief Switches the selective search techniques used by the next call to run.
+         */
+        void setOptions(const SearchOptions& options) { this->options = options; }
+
+        const SearchOptions& getOptions() const { return options; }
+
+        /**
+         * @brief Nodes visited by the last call to run so far.
+         */
+        uint64_t getNodes() const { return nodes; }
+
+        /**
+         * @brief Re-search counts of the last call to run so far.
+         */
+        const SearchStats& getStats() const { return stats; }
+
+        /**
+         * @brief Transposition table statistics of the last call to run so far, counted by this Search alone.
+         */
+        const TTStats& getTableStats() const { return tableStats; }
+};
+
+#endif
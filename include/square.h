@@ -2,13 +2,7 @@
 #define SQUARE_H
 
 #include <tuple>
-#include "basepiece.h"
-#include "queen.h"
-#include "king.h"
-#include "rook.h"
-#include "pawn.h"
-#include "knight.h"
-#include "bishop.h"
+#include "types.h"
 
 class Square {
 private:
@@ -16,8 +10,8 @@ private:
     // Chessboard squares have a location in form (rank, file)
     std::tuple<int, int> location;
 
-    // Squares store a piece. If square is empty, piece is nullptr
-    BasePiece* piece;
+    // Squares store a piece. If square is empty, piece is NO_PIECE
+    Piece piece;
 
 public:
 
@@ -26,17 +20,10 @@ public:
      * 
      * @param rank - integer location of the rank of this square
      * @param file - integer location of the file of this square
-     * @param piece - pointer to a BasePiece that occupies this square
+     * @param piece - piece that occupies this square, NO_PIECE if it is empty
      */
-    Square(int rank, int file, BasePiece* piece = nullptr);
+    Square(int rank, int file, Piece piece = NO_PIECE);
 
-    /*
-    Rule of Three implementation
-    */
-    ~Square();
-    Square(const Square& other);
-    Square& operator=(Square other);
-    
     /*
     Equality operator overloading
     */
@@ -48,28 +35,21 @@ public:
      * 
      * @return std::tuple<int, int> - location of this square
      */
-    std::tuple<int, int> getLocation();
+    std::tuple<int, int> getLocation() const;
 
     /**
      * @brief Returns the piece on this square
      * 
-     * @return BasePiece* - pointer to the piece on this square
-     */
-    BasePiece* getPiece();
-
-    /**
-     * @brief Setup setting pieces
-     * 
-     * @param pieceToSet 
+     * @return Piece - piece on this square, NO_PIECE if it is empty
      */
-    void setPieceAtStart(BasePiece* pieceToSet);
+    Piece getPiece() const;
     
     /**
-     * @brief Sets the BasePiece* on this square
+     * @brief Sets the piece on this square
      * 
-     * @param pieceToSet - BasePiece* to be on this square
+     * @param pieceToSet - piece to be on this square, NO_PIECE to empty it
      */
-    void setPiece(BasePiece* pieceToSet);
+    void setPiece(Piece pieceToSet);
 };
 
 #endif
@@ -0,0 +1,101 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+Work-stealing thread pool for batch jobs, such as perft suites or analysing many positions, where some
+jobs take far longer than others.
+
+Each worker has its own deque of tasks. A worker takes the newest task of its own deque first, and when
+that is empty steals the oldest task of another worker, so no worker sits idle while tasks are waiting
+anywhere. Tasks submitted by a task go to its own worker's deque. A task can be given an affinity to a
+worker, which queues it there; other workers may still steal it once they run out.
+
+The number of waiting tasks is bounded. submit blocks callers outside the pool while the pool is full,
+so a producer reading millions of positions never gets far ahead of the workers. Tasks submitted from
+inside the pool are never blocked, since the worker they would wait for may be their own.
+*/
+class ThreadPool {
+
+    private:
+        struct Worker {
+            std::mutex mutex;
+            std::deque<std::function<void()> > tasks;
+        };
+
+        std::vector<std::unique_ptr<Worker> > workers;
+        std::vector<std::thread> threads;
+        size_t capacity;
+
+        // Guards the counters below and the waits on the condition variables
+        std::mutex stateMutex;
+        std::condition_variable workAvailable;
+        std::condition_variable notFull;
+        std::condition_variable allDone;
+        size_t queued;          // tasks waiting in the deques
+        size_t unfinished;      // tasks submitted and not finished, waiting or running
+        size_t nextWorker;      // worker the next task without affinity goes to
+        bool stopping;
+        std::exception_ptr error;
+
+        void workerLoop(int index);
+
+        /**
+         * @brief Takes a task off the worker's own deque, or steals one from another worker.
+         * 
+         * @param index - index of the worker looking for a task
+         * @param task - set to the task taken
+         * @return true if a task was taken
+         */
+        bool popTask(int index, std::function<void()>& task);
+
+    public:
+        /**
+         * @brief Starts the worker threads.
+         * 
+         * @param threads - number of workers, 0 for one per core
+         * @param capacity - most tasks waiting at once before submit blocks
+         */
+        ThreadPool(int threads = 0, size_t capacity = 1024);
+
+        /**
+         * @brief Finishes every submitted task, then stops the workers.
+         */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Queues a task. Blocks while the pool is full, unless called from a task of this pool.
+         * 
+         * @param task - function to run on a worker
+         * @param affinity - index of the worker to queue the task on, or -1 to spread tasks over the workers
+         */
+        void submit(std::function<void()> task, int affinity = -1);
+
+        /**
+         * @brief Blocks until every submitted task has finished. If a task threw, the first exception thrown
+         * is rethrown here. Must not be called from a task of this pool.
+         */
+        void wait();
+
+        // Number of worker threads
+        int size() const { return int(workers.size()); }
+
+        /**
+         * @brief Index of the worker running the calling task, -1 when not called from a task of this pool.
+         */
+        int workerIndex() const;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef TIMEMANAGER_H
+#define TIMEMANAGER_H
+
+#include <chrono>
+#include <cstdint>
+
+struct SearchLimits;
+
+/*
+Splits a wall clock budget into two limits. The soft limit (optimum) is checked between iterations: no new
+iteration starts once it has passed, as it would likely not finish. It stretches when the best move keeps
+changing or the score drops, and shrinks when the best move is stable. The hard limit (maximum) is checked
+by the search every 1024 nodes and stops it in the middle of an iteration, so a deadline is never overrun
+by more than the time of 1024 nodes. A fixed movetime has no soft limit and is used in full.
+
+All times are in milliseconds, measured from the call to start.
+*/
+class TimeManager {
+
+    private:
+        std::chrono::steady_clock::time_point startTime;
+        int64_t optimum;
+        int64_t maximum;
+        bool limited;
+
+        // A fixed time per move is used in full: the search only stops at the hard limit
+        bool fixedTime;
+
+    public:
+        TimeManager();
+
+        /**
+         * @brief Starts the clock and sets the limits for one search.
+         * 
+         * @param limits - time budget of the search. Without movetime or time left for the side to move, the
+         * search is not limited by time
+         * @param whiteToPlay - side whose clock and increment are used
+         */
+        void start(const SearchLimits& limits, bool whiteToPlay);
+
+        /**
+         * @brief Milliseconds since start.
+         */
+        int64_t elapsed() const;
+
+        /**
+         * @brief Returns true if the search has a time budget.
+         */
+        bool isLimited() const { return limited; }
+
+        int64_t getOptimum() const { return optimum; }
+        int64_t getMaximum() const { return maximum; }
+
+        /**
+         * @brief Returns true once the hard limit has passed: the search must stop now.
+         */
+        bool hardLimitReached() const { return limited && elapsed() >= maximum; }
+
+        /**
+         * @brief Decides after a completed iteration whether to start another.
+         * 
+         * @param stableIterations - iterations in a row that ended with the same best move, 0 if it just changed
+         * @param scoreDrop - how far the score fell since the previous iteration, in centipawns
+         * @return true if the soft limit, scaled by the stability of the search, has passed
+         */
+        bool softLimitReached(int stableIterations, int scoreDrop) const;
+};
+
+#endif
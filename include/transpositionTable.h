@@ -0,0 +1,155 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "move.h"
+#include "zobrist.h"
+
+// How a stored score relates to the true score of the position
+enum Bound : uint8_t {
+    BOUND_NONE,
+    BOUND_UPPER,    // the search failed low, the true score is at most the stored score
+    BOUND_LOWER,    // the search failed high, the true score is at least the stored score
+    BOUND_EXACT
+};
+
+/*
+What a probe returns: the result of an earlier search of the position.
+*/
+struct TTData {
+    Move move;      // best move found, may be null
+    int score;      // score as stored, mate scores relative to the position (see Search)
+    int depth;      // depth the position was searched to
+    Bound bound;
+};
+
+/*
+Statistics of the probes and stores of one thread. Each thread counts into its own, so the shared table
+has no counters for the threads to fight over, and the callers add them up when reporting.
+*/
+struct TTStats {
+    uint64_t probes;        // probes made
+    uint64_t hits;          // probes that found their position
+    uint64_t collisions;    // stores that overwrote an entry of a different position from the current search
+
+    TTStats() : probes(0), hits(0), collisions(0) {}
+
+    TTStats& operator+=(const TTStats& other) {
+        probes += other.probes;
+        hits += other.hits;
+        collisions += other.collisions;
+        return *this;
+    }
+};
+
+/*
+One slot of the table, 16 bytes. The search data is packed into one 64 bit word and stored next to the
+key XORed with that word. A probe recomputes the key from both words, so an entry torn by two threads
+writing it at once no longer matches any key and is ignored. No locks are needed. Both words are atomics
+read and written with relaxed ordering, which compiles to plain loads and stores.
+
+Data layout: move bits 0-15, score 16-31, depth 32-39, bound 40-41, generation 42-47.
+*/
+struct TTEntry {
+    std::atomic<uint64_t> keyXorData;
+    std::atomic<uint64_t> data;
+};
+
+const int TT_BUCKET_SIZE = 4;
+
+/*
+Four entries filling exactly one 64 byte cache line, so a probe touches a single line.
+*/
+struct alignas(64) TTBucket {
+    TTEntry entries[TT_BUCKET_SIZE];
+};
+
+static_assert(sizeof(TTBucket) == 64, "A bucket must fill one cache line");
+
+/*
+Transposition table shared by every search thread. Sized in megabytes at runtime, rounded down to a power
+of two number of buckets; the low bits of the key pick the bucket. Within a bucket a new position replaces
+the entry with the lowest depth, counting entries from older searches as shallower.
+*/
+class TranspositionTable {
+
+    private:
+        std::unique_ptr<char[]> memory;
+        TTBucket* buckets;
+        size_t bucketCount;
+        uint8_t generation;
+
+        TTBucket& bucketOf(Key key) const { return buckets[key & (bucketCount - 1)]; }
+
+    public:
+        /**
+         * @brief Construct an empty table.
+         * 
+         * @param megabytes - size of the table, at least one bucket is allocated
+         */
+        TranspositionTable(size_t megabytes = 16);
+
+        TranspositionTable(const TranspositionTable&) = delete;
+        TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+        /**
+         * @brief Reallocates the table with a new size, losing every entry. Must not be called during a search.
+         * 
+         * @param megabytes - new size of the table
+         */
+        void resize(size_t megabytes);
+
+        /**
+         * @brief Empties every entry. Must not be called during a search.
+         * 
+         * @param threads - number of threads clearing slices of the table at once
+         */
+        void clear(int threads = 1);
+
+        /**
+         * @brief Starts a new search. Entries of earlier searches are replaced first.
+         */
+        void newSearch() { generation = (generation + 1) & 63; }
+
+        /**
+         * @brief Looks a position up.
+         * 
+         * @param key - Zobrist key of the position
+         * @param data - filled with the stored data if the position is found
+         * @param stats - statistics of the calling thread to count the probe in, or null
+         * @return true if the position is in the table
+         */
+        bool probe(Key key, TTData& data, TTStats* stats = nullptr);
+
+        /**
+         * @brief Stores the result of a search of a position. An entry of the same position keeps its move if the
+         * new one is null.
+         * 
+         * @param key - Zobrist key of the position
+         * @param move - best move found, or a null Move
+         * @param score - score to store, mate scores relative to the position
+         * @param depth - depth searched, -128 to 127
+         * @param bound - how score relates to the true score
+         * @param stats - statistics of the calling thread to count a collision in, or null
+         */
+        void store(Key key, Move move, int score, int depth, Bound bound, TTStats* stats = nullptr);
+
+        /**
+         * @brief Hints the CPU to fetch the bucket of key into the cache, ahead of a probe.
+         */
+        void prefetch(Key key) const;
+
+        /**
+         * @brief Estimated fill of the table in permille, counting only entries of the current search.
+         */
+        int hashfull() const;
+
+        // Number of buckets in the table
+        size_t size() const { return bucketCount; }
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef TYPES_H
+#define TYPES_H
+
+#include <cstdint>
+#include <cctype>
+#include <string>
+
+/*
+Squares are indexed 0..63 in the same order as the (rank, file) tuples used by the Board:
+index 0 is a8 (rank 0, file 0) and index 63 is h1 (rank 7, file 7). A FEN string lists
+the squares in exactly this order.
+*/
+inline int squareIndex(int rank, int file) {
+    return rank * 8 + file;
+}
+
+inline int rankOf(int sq) {
+    return sq >> 3;
+}
+
+inline int fileOf(int sq) {
+    return sq & 7;
+}
+
+// Colors of the two sides
+enum Color {
+    WHITE,
+    BLACK
+};
+
+inline Color operator~(Color c) {
+    return Color(c ^ 1);
+}
+
+// Piece types, in the order used to index the per-type bitboards of the Board
+enum PieceType {
+    PAWN,
+    KNIGHT,
+    BISHOP,
+    ROOK,
+    QUEEN,
+    KING,
+    NO_PIECE_TYPE
+};
+
+// Material values of the piece types in centipawns, indexed by PieceType. The king is never traded. These are
+// the middlegame values of the evaluation (see psqt.h), so static exchange evaluation and the search's pruning
+// margins count in the same units as the scores they are compared with
+const int PieceValue[6] = { 82, 337, 365, 477, 1025, 0 };
+
+// A piece is a color and a type packed into a single byte (color * 6 + type)
+enum Piece : uint8_t {
+    W_PAWN, W_KNIGHT, W_BISHOP, W_ROOK, W_QUEEN, W_KING,
+    B_PAWN, B_KNIGHT, B_BISHOP, B_ROOK, B_QUEEN, B_KING,
+    NO_PIECE
+};
+
+inline Piece makePiece(Color c, PieceType pt) {
+    return Piece(c * 6 + pt);
+}
+
+inline Color colorOf(Piece p) {
+    return Color(p >= B_PAWN);
+}
+
+inline PieceType typeOf(Piece p) {
+    return PieceType(p % 6);
+}
+
+/**
+ * @brief Converts a FEN piece character to a Piece. White pieces are uppercase, black pieces are lowercase.
+ *
+ * @param c - FEN character, one of PNBRQK or pnbrqk
+ * @return Piece - the matching piece, NO_PIECE if c is not a piece character
+ */
+inline Piece pieceFromFENChar(char c) {
+    Color color = isupper(c) ? WHITE : BLACK;
+    switch (tolower(c)) {
+        case 'p': return makePiece(color, PAWN);
+        case 'n': return makePiece(color, KNIGHT);
+        case 'b': return makePiece(color, BISHOP);
+        case 'r': return makePiece(color, ROOK);
+        case 'q': return makePiece(color, QUEEN);
+        case 'k': return makePiece(color, KING);
+        default:  return NO_PIECE;
+    }
+}
+
+/**
+ * @brief Converts a Piece to its FEN character.
+ *
+ * @param p - piece to convert
+ * @return char - FEN character of the piece, '-' for NO_PIECE
+ */
+inline char pieceToFENChar(Piece p) {
+    if (p == NO_PIECE)
+        return '-';
+    char c = "pnbrqk"[typeOf(p)];
+    return (colorOf(p) == WHITE) ? char(toupper(c)) : c;
+}
+
+/**
+ * @brief Converts a Piece to its two character id, used when printing the board: the color ('w' or 'b')
+ * followed by the type (K, Q, R, B, N, or p for pawns).
+ *
+ * @param p - piece to convert
+ * @return std::string - id of the piece, for instance "wK" or "bp"
+ */
+inline std::string pieceToID(Piece p) {
+    std::string id(1, (colorOf(p) == WHITE) ? 'w' : 'b');
+    id += "pNBRQK"[typeOf(p)];
+    return id;
+}
+
+#endif
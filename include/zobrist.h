@@ -0,0 +1,28 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+#include "types.h"
+
+// 64 bit Zobrist hash of a position
+typedef uint64_t Key;
+
+/*
+Random keys XORed together to hash a position. A position's key is the XOR of the key of every 
+piece on its square, the key of the castling rights, the key of the en passant file (if there is 
+an en passant target) and SideKey if black is to play. Every change a move makes is undone by 
+XORing the same key again, so the Board updates its key incrementally.
+*/
+extern Key ZobristPieces[12][64];
+extern Key ZobristCastling[16];
+extern Key ZobristEnPassant[8];
+extern Key ZobristSide;
+
+/**
+ * @brief Fills the Zobrist keys from a fixed seed, so keys are the same in every run. 
+ * Called by the Board; safe to call more than once and from several threads.
+ */
+void initZobrist();
+
+#endif
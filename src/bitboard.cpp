@@ -0,0 +1,252 @@
+#include "bitboard.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if HAS_PEXT
+#include <cpuid.h>
+#endif
+
+Magic RookMagics[64];
+Magic BishopMagics[64];
+Bitboard KnightAttacks[64];
+Bitboard KingAttacks[64];
+Bitboard PawnAttacks[2][64];
+Bitboard BetweenBB[64][64];
+Bitboard LineBB[64][64];
+SliderAttackPath sliderAttackPath = MAGIC_ATTACKS;
+
+// Attack tables shared by all squares. Each square owns a slice of 2^(relevant bits) entries
+static Bitboard RookTable[0x19000];
+static Bitboard BishopTable[0x1480];
+
+namespace {
+
+    /*
+    Magic numbers for each square, found offline with a sparse random search. Any number that
+    maps every blocker subset of the mask to a slot holding the right attack set works; these
+    use exactly popCount(mask) index bits, so the tables are as small as possible.
+    */
+    const Bitboard RookMagicNumbers[64] = {
+        0x1080004008801020ULL, 0x0840092002C03000ULL, 0x1900200010400900ULL, 0x0880100008000480ULL,
+        0x4200100420080200ULL, 0x8100020100080400ULL, 0x0200040110886200ULL, 0x0200008040220411ULL,
+        0x0404800084400220ULL, 0x0000401000402000ULL, 0x0086001081220440ULL, 0x0408800800100280ULL,
+        0x000A001201040820ULL, 0x8848800200840080ULL, 0x4001000100040200ULL, 0x0442000102105084ULL,
+        0x9080010020804100ULL, 0x0040404000201009ULL, 0x0000808010002009ULL, 0x2200090021D00100ULL,
+        0x0008008008040080ULL, 0x0004004002010040ULL, 0x0011040008015042ULL, 0x00000A0001768104ULL,
+        0x0000800080204009ULL, 0x2010004140002001ULL, 0x9800200280100080ULL, 0x1000100080080080ULL,
+        0x0442000A00049020ULL, 0x2100040080020080ULL, 0x0800120400900148ULL, 0x0010040A00128541ULL,
+        0x2800804000800030ULL, 0x1010002000400041ULL, 0x4000200011004100ULL, 0x0610008410800800ULL,
+        0x0400802402800800ULL, 0xC100020080800400ULL, 0x0002000802000401ULL, 0x0182085882000401ULL,
+        0x0220204000808000ULL, 0x2860100040024022ULL, 0x0001002004110040ULL, 0x99101042000A0020ULL,
+        0x0004080004008080ULL, 0x0010040002008080ULL, 0x2012004881020004ULL, 0x8300842444820011ULL,
+        0x0088403882010200ULL, 0x0820400080210100ULL, 0x0110910040A00300ULL, 0x0801100280080480ULL,
+        0x0242009008200600ULL, 0x1002000489500200ULL, 0x0040800200010080ULL, 0x0091800041000080ULL,
+        0x0000209300488001ULL, 0x04C1002414824001ULL, 0x020020000B001041ULL, 0x7000100004200901ULL,
+        0x8002002004100802ULL, 0x30010002084C0007ULL, 0x0888221800813004ULL, 0x4000002840840112ULL
+    };
+
+    const Bitboard BishopMagicNumbers[64] = {
+        0x2048017020910100ULL, 0x0044410424008008ULL, 0x040828A400900000ULL, 0x8002209200022000ULL,
+        0x0002021000540002ULL, 0x0021018840000000ULL, 0x00009E8420204002ULL, 0x00A0920110084480ULL,
+        0x4003062018010110ULL, 0x0221046812004E09ULL, 0x01E11002958912A0ULL, 0x0000044410804000ULL,
+        0x0000821210000080ULL, 0x080201102210A800ULL, 0x0080040411045004ULL, 0x00704A1842021000ULL,
+        0x1005061070322800ULL, 0x0018001010410444ULL, 0x0010000800401420ULL, 0x2204002844000800ULL,
+        0x2052020412022280ULL, 0x000A020101008208ULL, 0x0040400201042000ULL, 0x03E1082040480410ULL,
+        0x1004200004208414ULL, 0x08700400984808C8ULL, 0x0088080004004410ULL, 0x008C0240140100A2ULL,
+        0x0008840001822000ULL, 0x0050088001080100ULL, 0x98140840040A2200ULL, 0x3002020900210110ULL,
+        0x1004040640206000ULL, 0x1090909000840400ULL, 0x9002444810100020ULL, 0x4000020080080080ULL,
+        0x0028020400011010ULL, 0x0290808300020100ULL, 0x8010020882004410ULL, 0x0604010040082C20ULL,
+        0x20040104C0801008ULL, 0x6004208424001050ULL, 0x1002840041000800ULL, 0x0200042018000102ULL,
+        0xA8002000A0821C00ULL, 0x0040080802201910ULL, 0x0222620444000100ULL, 0x0002080041020088ULL,
+        0x1500820110401050ULL, 0x0000492090100080ULL, 0x0900410041100000ULL, 0x0302000420880000ULL,
+        0x0010501202020020ULL, 0x0008200490049040ULL, 0x0462080214A40120ULL, 0x2421310102008100ULL,
+        0x2400420080884060ULL, 0x0800804406184208ULL, 0x0B0080124A084400ULL, 0x082E082300840412ULL,
+        0x6051049040082200ULL, 0xC610211002102101ULL, 0x0000048808010433ULL, 0x0010200804405440ULL
+    };
+
+    /**
+     * @brief Walks the rays of a slider from sq, stopping at (and including) the first occupied
+     * square of each ray. Only used to build the tables.
+     */
+    Bitboard slidingAttacks(PieceType pt, int sq, Bitboard occupied) {
+        static const int rookDirections[4][2] = { {1, 0}, {0, 1}, {-1, 0}, {0, -1} };
+        static const int bishopDirections[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+        const int (*directions)[2] = (pt == ROOK) ? rookDirections : bishopDirections;
+
+        Bitboard attacks = 0;
+        for (int d = 0; d < 4; d++) {
+            int rank = rankOf(sq) + directions[d][0];
+            int file = fileOf(sq) + directions[d][1];
+            while (0 <= rank && rank < 8 && 0 <= file && file < 8) {
+                Bitboard b = squareBB(squareIndex(rank, file));
+                attacks |= b;
+                if (occupied & b)
+                    break;
+                rank += directions[d][0];
+                file += directions[d][1];
+            }
+        }
+        return attacks;
+    }
+
+    /**
+     * @brief Fills the magic entries and attack table of one slider type. For each square the mask
+     * holds the squares whose occupancy changes the attacks (board edges excluded), and every subset
+     * of the mask stores its attack set in the slot picked by the magic number.
+     */
+    void initMagics(PieceType pt, const Bitboard magicNumbers[], Bitboard table[], Magic magics[]) {
+        Bitboard* next = table;
+        for (int sq = 0; sq < 64; sq++) {
+            Magic& m = magics[sq];
+
+            // Edge squares never block a ray, unless the slider itself stands on that edge
+            Bitboard rank1 = 0xFFULL, rank8 = 0xFFULL << 56;
+            Bitboard fileA = 0x0101010101010101ULL, fileH = fileA << 7;
+            Bitboard edges = ((rank1 | rank8) & ~(rank1 << (8 * rankOf(sq))))
+                           | ((fileA | fileH) & ~(fileA << fileOf(sq)));
+
+            m.mask = slidingAttacks(pt, sq, 0) & ~edges;
+            m.magic = magicNumbers[sq];
+            m.shift = 64 - popCount(m.mask);
+            m.attacks = next;
+            next += Bitboard(1) << popCount(m.mask);
+
+            // Enumerate every subset of the mask (Carry-Rippler) and store its attack set
+            Bitboard b = 0;
+            do {
+                m.attacks[m.index(b)] = slidingAttacks(pt, sq, b);
+                b = (b - m.mask) & m.mask;
+            } while (b);
+        }
+    }
+
+    /**
+     * @brief Squares reached from sq by each (rank, file) step in steps that stays on the board.
+     */
+    Bitboard stepAttacks(int sq, const int steps[][2], int count) {
+        Bitboard attacks = 0;
+        for (int i = 0; i < count; i++) {
+            int rank = rankOf(sq) + steps[i][0];
+            int file = fileOf(sq) + steps[i][1];
+            if (0 <= rank && rank < 8 && 0 <= file && file < 8)
+                attacks |= squareBB(squareIndex(rank, file));
+        }
+        return attacks;
+    }
+
+    void initStepAttacks() {
+        static const int knightSteps[8][2] = { {2, 1}, {1, 2}, {-1, 2}, {-2, 1}, {-2, -1}, {-1, -2}, {1, -2}, {2, -1} };
+        static const int kingSteps[8][2] = { {1, 1}, {1, 0}, {1, -1}, {0, 1}, {0, -1}, {-1, 1}, {-1, 0}, {-1, -1} };
+        static const int whitePawnSteps[2][2] = { {-1, -1}, {-1, 1} };
+        static const int blackPawnSteps[2][2] = { {1, -1}, {1, 1} };
+
+        for (int sq = 0; sq < 64; sq++) {
+            KnightAttacks[sq] = stepAttacks(sq, knightSteps, 8);
+            KingAttacks[sq] = stepAttacks(sq, kingSteps, 8);
+            PawnAttacks[WHITE][sq] = stepAttacks(sq, whitePawnSteps, 2);
+            PawnAttacks[BLACK][sq] = stepAttacks(sq, blackPawnSteps, 2);
+        }
+    }
+
+    // Needs the slider tables, as the lines are read from the attacks of an empty board
+    void initLines() {
+        for (int a = 0; a < 64; a++) {
+            for (int b = 0; b < 64; b++) {
+                BetweenBB[a][b] = 0;
+                LineBB[a][b] = 0;
+                if (a == b)
+                    continue;
+
+                // Each square stops the other's ray, so the overlap of the two rays is the gap between them
+                if (bishopAttacks(a, 0) & squareBB(b)) {
+                    LineBB[a][b] = (bishopAttacks(a, 0) & bishopAttacks(b, 0)) | squareBB(a) | squareBB(b);
+                    BetweenBB[a][b] = bishopAttacks(a, squareBB(b)) & bishopAttacks(b, squareBB(a));
+                }
+                else if (rookAttacks(a, 0) & squareBB(b)) {
+                    LineBB[a][b] = (rookAttacks(a, 0) & rookAttacks(b, 0)) | squareBB(a) | squareBB(b);
+                    BetweenBB[a][b] = rookAttacks(a, squareBB(b)) & rookAttacks(b, squareBB(a));
+                }
+            }
+        }
+    }
+
+    // PEXT is correct on every BMI2 CPU, but AMD runs it in microcode before Zen 3 (family 19h),
+    // where it is far slower than a magic multiply
+    bool cpuHasFastPext() {
+#if HAS_PEXT
+        if (!cpuSupportsPext())
+            return false;
+        unsigned eax, ebx, ecx, edx;
+        if (__get_cpuid(0, &eax, &ebx, &ecx, &edx) && ebx == 0x68747541) { // "Auth" of AuthenticAMD
+            __get_cpuid(1, &eax, &ebx, &ecx, &edx);
+            unsigned family = (eax >> 8) & 0xF;
+            if (family == 0xF)
+                family += (eax >> 20) & 0xFF;
+            return family >= 0x19;
+        }
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void buildTables() {
+        initMagics(ROOK, RookMagicNumbers, RookTable, RookMagics);
+        initMagics(BISHOP, BishopMagicNumbers, BishopTable, BishopMagics);
+    }
+
+    bool initTables() {
+        SliderAttackPath path = cpuHasFastPext() ? PEXT_ATTACKS : MAGIC_ATTACKS;
+
+        const char* forced = std::getenv("CHESS_SLIDER_ATTACKS");
+        if (forced && std::strcmp(forced, "magic") == 0)
+            path = MAGIC_ATTACKS;
+        else if (forced && std::strcmp(forced, "pext") == 0)
+            path = PEXT_ATTACKS;
+
+        if (path == PEXT_ATTACKS && !cpuSupportsPext())
+            path = MAGIC_ATTACKS;
+
+        sliderAttackPath = path;
+        buildTables();
+        initStepAttacks();
+        initLines();
+        std::cerr << "info string slider attacks: " << sliderAttackPathName() << std::endl;
+        return true;
+    }
+}
+
+void initBitboards() {
+    // Since C++11 a local static is initialized exactly once: threads arriving together wait until the first
+    // one has finished building the tables. The other global tables (Zobrist keys, piece-square tables,
+    // search reductions) are set up the same way
+    static bool initialized = initTables();
+    (void)initialized;
+}
+
+bool cpuSupportsPext() {
+#if HAS_PEXT
+    unsigned eax, ebx, ecx, edx;
+    // CPUID leaf 7, subleaf 0: EBX bit 8 is BMI2
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        return false;
+    return (ebx >> 8) & 1;
+#else
+    return false;
+#endif
+}
+
+SliderAttackPath setSliderAttackPath(SliderAttackPath path) {
+    initBitboards();
+    if (path == PEXT_ATTACKS && !cpuSupportsPext())
+        path = MAGIC_ATTACKS;
+    sliderAttackPath = path;
+    buildTables();
+    return path;
+}
+
+const char* sliderAttackPathName() {
+    return (sliderAttackPath == PEXT_ATTACKS) ? "pext" : "magic";
+}
@@ -17,33 +17,56 @@ Board::Board(std::string fen) {
 }
 
 void Board::initBoard() {
-    // 8x8 grid on squares
-    for (int i = 0; i < 8; i++) {
-        std::vector<Square> rank;
-        for (int j = 0; j < 8; j++) {
-            rank.push_back(Square(i, j, nullptr));
-        }
-        board.push_back(rank);
-    }
+    // Slider attack tables and Zobrist keys are built once and shared by every board
+    initBitboards();
+    initZobrist();
+    initPSQT();
+
+    clearBoard();
+
+    // Room for a long game, so makeMove does not have to grow the undo stack during a search
+    undoStack.reserve(1024);
 }
 
 Board::~Board() {}
 
 
 Board::Board(const Board& other) {
-    board = other.board;
+    // A copy gets its own undo stack with room to search from it without reallocating
+    undoStack.reserve(std::max(size_t(1024), other.undoStack.size()));
+    undoStack = other.undoStack;
+    std::copy(&other.pieceBB[0][0], &other.pieceBB[0][0] + 12, &pieceBB[0][0]);
+    std::copy(other.colorBB, other.colorBB + 2, colorBB);
+    occupiedBB = other.occupiedBB;
+    key = other.key;
+    psqMidgame = other.psqMidgame;
+    psqEndgame = other.psqEndgame;
+    phase = other.phase;
+    std::copy(other.mailbox, other.mailbox + 64, mailbox);
+    whiteKingLocation = other.whiteKingLocation;
+    blackKingLocation = other.blackKingLocation;
     whiteToPlay = other.whiteToPlay;
     castlingRights = other.castlingRights;
-    enPassantTargets = other.enPassantTargets;
+    enPassantSquare = other.enPassantSquare;
     halfMove = other.halfMove;
     moveNumber = other.moveNumber;
 }
 
 Board& Board::operator=(Board other) {
-    std::swap(board, other.board);
+    std::swap(undoStack, other.undoStack);
+    std::swap(pieceBB, other.pieceBB);
+    std::swap(colorBB, other.colorBB);
+    std::swap(occupiedBB, other.occupiedBB);
+    std::swap(key, other.key);
+    std::swap(psqMidgame, other.psqMidgame);
+    std::swap(psqEndgame, other.psqEndgame);
+    std::swap(phase, other.phase);
+    std::swap(mailbox, other.mailbox);
+    std::swap(whiteKingLocation, other.whiteKingLocation);
+    std::swap(blackKingLocation, other.blackKingLocation);
     std::swap(whiteToPlay, other.whiteToPlay);
     std::swap(castlingRights, other.castlingRights);
-    std::swap(enPassantTargets, other.enPassantTargets);
+    std::swap(enPassantSquare, other.enPassantSquare);
     std::swap(halfMove, other.halfMove);
     std::swap(moveNumber, other.moveNumber);
 
@@ -55,13 +78,17 @@ void Board::loadFromFEN(std::string fen) {
     // Break FEN string into components
     std::vector<std::string> parsedFEN = parseFEN(fen);
 
+    // Start from an empty board so no pieces of a previous position remain
+    clearBoard();
+    undoStack.clear();
+
     // Turn to play
     whiteToPlay = (parsedFEN[1] == "w") ? true : false;
 
     // Castling rights, en passant targets, and move count
     CastlingRights cr(parsedFEN[2]);
     castlingRights = cr;
-    enPassantTargets = parsedFEN[3];
+    enPassantSquare = squareFromName(parsedFEN[3]);
     halfMove = std::stoi(parsedFEN[4]);
     moveNumber = std::stoi(parsedFEN[5]);
 
@@ -82,55 +109,38 @@ void Board::loadFromFEN(std::string fen) {
                 file = file + int(c) - '0';
             else {
 
-                // Determine color of piece
-                char color = (isupper(c)) ? 'w': 'b';
-                char id;
-
-                // Uppercase characters mean white minor and major pieces
-                if (isupper(c)) {
-                    if (c != 'P') 
-                        id = c;
-                    // White pawns are represented with an uppercase 'P'
-                    else
-                        id = tolower(c);
-                }
-
-                // Lowercase characters mean black minor and major pieces
-                else {
-                    if (c != 'p')
-                        id = toupper(c);
-                    // Black pawns are represented with a lowercase 'p'
-                    else 
-                        id = c;
-                }
-
                 // Adding piece to board and moving to the next file in this rank
                 std::tuple<int, int> position = std::make_tuple(rank, file);
-                board[rank][file].setPieceAtStart(new BasePiece(std::string(1, color) + id, position));
-                if (board[rank][file].getPiece()->getID() == "wK") {
-                    whiteKingLocation = board[rank][file].getPiece()->getPosition();
+                Piece piece = pieceFromFENChar(c);
+                putPiece(piece, squareIndex(rank, file));
+                if (piece == W_KING) {
+                    whiteKingLocation = position;
                 }
-                if (board[rank][file].getPiece()->getID() == "bK") {
-                    blackKingLocation = board[rank][file].getPiece()->getPosition();
+                if (piece == B_KING) {
+                    blackKingLocation = position;
                 }
                 file++;
             }
         }
     }
+
+    // Hash the whole position once; makeMove keeps the key up to date from here
+    key = computeKey();
 }
 
 std::string Board::toFEN() {
     std::string fen;
     // Iterate over the ranks of the board
-    for (int rank = 0; rank < board.size(); rank++) {
+    for (int rank = 0; rank < 8; rank++) {
 
         // Number of empty squares before another piece
         int emptyCount = 0;
 
         // Iterate over the files of the rank
-        for (int file = 0; file < board[rank].size(); file++) {
+        for (int file = 0; file < 8; file++) {
+            Piece piece = mailbox[squareIndex(rank, file)];
             // Increment emptyCount if no piece at square
-            if (board[rank][file].getPiece() == nullptr) {
+            if (piece == NO_PIECE) {
                 emptyCount++;
             }
             // Add piece type to string. White pieces use capital letters, black pieces use lowercase letters
@@ -139,13 +149,7 @@ std::string Board::toFEN() {
                     fen += std::to_string(emptyCount);       
                     emptyCount = 0;
                 }
-                std::string id = board[rank][file].getPiece()->getID();
-                if (id[0] == 'w') {
-                    fen += toupper(id[1]);
-                }
-                else {
-                    fen += tolower(id[1]);
-                }
+                fen += pieceToFENChar(piece);
             }
         }
         if (emptyCount > 0) {
@@ -160,7 +164,7 @@ std::string Board::toFEN() {
     // Create the rest of the FEN string - active color, castling rights, en passant target, half move and move number
     fen += (getWhiteToPlay()) ? " w " : " b ";
     fen += castlingRights.toString();
-    fen += " - ";
+    fen += " " + getEnPassantTargets() + " ";
     fen += std::to_string(halfMove);
     fen += " " + std::to_string(moveNumber);
 
@@ -168,11 +172,57 @@ std::string Board::toFEN() {
 }
 
 void Board::clearBoard() {
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            board[i][j] = Square(i, j, nullptr);
+    // Empty bitboards and mailbox
+    for (int c = 0; c < 2; c++) {
+        for (int pt = 0; pt < 6; pt++) {
+            pieceBB[c][pt] = 0;
         }
+        colorBB[c] = 0;
+    }
+    occupiedBB = 0;
+    for (int sq = 0; sq < 64; sq++) {
+        mailbox[sq] = NO_PIECE;
     }
+    key = 0;
+    psqMidgame = psqEndgame = phase = 0;
+}
+
+void Board::putPiece(Piece piece, int sq) {
+    Bitboard b = squareBB(sq);
+    pieceBB[colorOf(piece)][typeOf(piece)] |= b;
+    colorBB[colorOf(piece)] |= b;
+    occupiedBB |= b;
+    mailbox[sq] = piece;
+    key ^= ZobristPieces[piece][sq];
+    psqMidgame += PsqMidgame[piece][sq];
+    psqEndgame += PsqEndgame[piece][sq];
+    phase += PhaseWeight[typeOf(piece)];
+}
+
+void Board::removePiece(int sq) {
+    Piece piece = mailbox[sq];
+    Bitboard b = squareBB(sq);
+    pieceBB[colorOf(piece)][typeOf(piece)] ^= b;
+    colorBB[colorOf(piece)] ^= b;
+    occupiedBB ^= b;
+    mailbox[sq] = NO_PIECE;
+    key ^= ZobristPieces[piece][sq];
+    psqMidgame -= PsqMidgame[piece][sq];
+    psqEndgame -= PsqEndgame[piece][sq];
+    phase -= PhaseWeight[typeOf(piece)];
+}
+
+void Board::movePiece(int from, int to) {
+    Piece piece = mailbox[from];
+    Bitboard fromTo = squareBB(from) | squareBB(to);
+    pieceBB[colorOf(piece)][typeOf(piece)] ^= fromTo;
+    colorBB[colorOf(piece)] ^= fromTo;
+    occupiedBB ^= fromTo;
+    mailbox[from] = NO_PIECE;
+    mailbox[to] = piece;
+    key ^= ZobristPieces[piece][from] ^ ZobristPieces[piece][to];
+    psqMidgame += PsqMidgame[piece][to] - PsqMidgame[piece][from];
+    psqEndgame += PsqEndgame[piece][to] - PsqEndgame[piece][from];
 }
 
 std::vector<std::string> Board::parseFEN(std::string fen) {
@@ -196,16 +246,29 @@ std::vector<std::string> Board::parseFEN(std::string fen) {
 }
 
 std::vector<std::vector<Square> > Board::getBoard() {
-return board;
-}
-
-std::vector<Square>& Board::operator[](int idx) {
-    return board[idx];
+    std::vector<std::vector<Square> > grid;
+    for (int i = 0; i < 8; i++) {
+        std::vector<Square> rank;
+        for (int j = 0; j < 8; j++) {
+            rank.push_back(Square(i, j, mailbox[squareIndex(i, j)]));
+        }
+        grid.push_back(rank);
+    }
+    return grid;
 }
 
 bool Board::operator==(const Board& other){
-    Board o = other;
-    return toFEN() == o.toFEN();
+    // Different keys always mean different positions. Equal keys are confirmed square by square,
+    // as two positions can share a key
+    if (key != other.key) {
+        return false;
+    }
+    return std::equal(mailbox, mailbox + 64, other.mailbox)
+        && whiteToPlay == other.whiteToPlay
+        && castlingRights.toMask() == other.castlingRights.toMask()
+        && enPassantSquare == other.enPassantSquare
+        && halfMove == other.halfMove
+        && moveNumber == other.moveNumber;
 }
 
 bool Board::operator!=(const Board& other){
@@ -215,11 +278,12 @@ bool Board::operator!=(const Board& other){
 void Board::print() {
 
     // Iterate over board and print out piece id, '--' if empty
-    for (int i = 0; i < board.size(); i++) {
+    for (int i = 0; i < 8; i++) {
         std::string rank = "";
-        for (int j = 0; j < board.size(); j++) {
-            if (board[i][j].getPiece())
-                rank = rank + board[i][j].getPiece()->getID() + " ";
+        for (int j = 0; j < 8; j++) {
+            Piece piece = mailbox[squareIndex(i, j)];
+            if (piece != NO_PIECE)
+                rank = rank + pieceToID(piece) + " ";
             else
                 rank = rank + "--" + " ";
         }
@@ -228,753 +292,886 @@ void Board::print() {
 }
 
 void Board::makeMove(Move move) {
-    // Set end squre piece to moved piece
-    getSquare(move.end).setPiece(move.pieceMoved);
-    // Set position of moved piece to end square
-    move.pieceMoved->setPosition(move.end);
-    // Set start square piece to empty
-    getSquare(move.start).setPiece(nullptr);
+    if (whiteToPlay) {
+        doMove<WHITE>(move);
+    }
+    else {
+        doMove<BLACK>(move);
+    }
+}
+
+template<Color Us>
+void Board::doMove(Move move) {
+    const Color Them = (Us == WHITE) ? BLACK : WHITE;
+    // Ranks of our and the opponent's back row
+    const int OurRank = (Us == WHITE) ? 7 : 0;
+    const int TheirRank = (Us == WHITE) ? 0 : 7;
+
+    int from = move.from();
+    int to = move.to();
+    Piece moved = mailbox[from];
+
+    // En passant captures the pawn beside the starting square, not a piece on the ending square
+    int captureSquare = move.isEnPassant() ? squareIndex(rankOf(from), fileOf(to)) : to;
+    Piece captured = mailbox[captureSquare];
+
+    // Save the state this move overwrites so unmakeMove can restore it
+    UndoInfo undo;
+    undo.captured = captured;
+    undo.castlingRights = castlingRights;
+    undo.enPassantSquare = enPassantSquare;
+    undo.halfMove = halfMove;
+    undo.key = key;
+    undoStack.push_back(undo);
+
+    // Take the old castling rights and en passant target out of the key. The pieces are hashed
+    // by putPiece, removePiece and movePiece
+    key ^= ZobristCastling[castlingRights.toMask()];
+    if (enPassantSquare != -1) {
+        key ^= ZobristEnPassant[fileOf(enPassantSquare)];
+    }
+
+    // Update the bitboards and mailbox
+    if (captured != NO_PIECE) {
+        removePiece(captureSquare);
+    }
+    movePiece(from, to);
+
+    // A promoted pawn is replaced by the piece it promotes to
+    if (move.isPromotion()) {
+        removePiece(to);
+        putPiece(makePiece(Us, move.promotionType()), to);
+    }
+
+    // A double pawn push makes the square it skipped the en passant target
+    enPassantSquare = move.isDoublePawnPush() ? (from + to) / 2 : -1;
 
     // increment move number when black makes a move
-    if (!whiteToPlay) {
+    if (Us == BLACK) {
         moveNumber++;
     }
 
     // Change active color
-    whiteToPlay = !whiteToPlay;
+    whiteToPlay = (Them == WHITE);
 
-    // Half move count
-    if (move.pieceMoved->getID()[0] != 'p' || move.pieceCaptured == nullptr) {
-        halfMove++;
+    // Half move count resets on pawn moves and captures
+    if (moved == makePiece(Us, PAWN) || captured != NO_PIECE) {
+        halfMove = 0;
     }
     else {
-        halfMove = 0;
+        halfMove++;
     }
     
-    // Castling
-    if (move.isCastleMove) {
-
-        // Kingside castle
-        if (std::get<1>(move.end) > std::get<1>(move.start)) {
-            // Black
-            if (std::get<0>(move.start) == 0) {
-                board[0][5].setPiece(board[0][7].getPiece());
-                board[0][7].setPiece(nullptr);
-                castlingRights.blackKingSide = false;
-                castlingRights.blackQueenSide = false;
-            }
-            // White
-            else {
-                board[7][5].setPiece(board[7][7].getPiece());
-                board[7][7].setPiece(nullptr);
-                castlingRights.whiteKingSide = false;
-                castlingRights.whiteQueenSide = false;
-            }
-        }
-        else {
-            // Black
-            if (std::get<0>(move.start) == 0) {
-                board[0][3].setPiece(board[0][0].getPiece());
-                board[0][0].setPiece(nullptr);
-                castlingRights.blackKingSide = false;
-                castlingRights.blackQueenSide = false;
-            }
-            // White
-            else {
-                board[7][3].setPiece(board[7][0].getPiece());
-                board[7][0].setPiece(nullptr);
-                castlingRights.whiteKingSide = false;
-                castlingRights.whiteQueenSide = false;
-            }
-        }
+    // Castling also moves the rook next to the king
+    if (move.isCastle()) {
+        int rookFrom = (move.flag() == KING_CASTLE) ? squareIndex(OurRank, 7) : squareIndex(OurRank, 0);
+        int rookTo = (move.flag() == KING_CASTLE) ? squareIndex(OurRank, 5) : squareIndex(OurRank, 3);
+        movePiece(rookFrom, rookTo);
+    }
+
+    // Moving the king loses both castling rights, and moving a rook loses the right to castle with it.
+    // Capturing a rook on its starting square loses the opponent's right to castle with that rook
+    bool& ourKingSide = (Us == WHITE) ? castlingRights.whiteKingSide : castlingRights.blackKingSide;
+    bool& ourQueenSide = (Us == WHITE) ? castlingRights.whiteQueenSide : castlingRights.blackQueenSide;
+    bool& theirKingSide = (Us == WHITE) ? castlingRights.blackKingSide : castlingRights.whiteKingSide;
+    bool& theirQueenSide = (Us == WHITE) ? castlingRights.blackQueenSide : castlingRights.whiteQueenSide;
+    if (from == squareIndex(OurRank, 4) || from == squareIndex(OurRank, 7)) {
+        ourKingSide = false;
+    }
+    if (from == squareIndex(OurRank, 4) || from == squareIndex(OurRank, 0)) {
+        ourQueenSide = false;
+    }
+    if (to == squareIndex(TheirRank, 7)) {
+        theirKingSide = false;
+    }
+    if (to == squareIndex(TheirRank, 0)) {
+        theirQueenSide = false;
     }
 
     // Updating king locations
-    if (move.pieceMoved->getID() == "wK") {
-        whiteKingLocation = move.end;
+    if (moved == makePiece(Us, KING)) {
+        ((Us == WHITE) ? whiteKingLocation : blackKingLocation) = move.getEnd();
     }
-    else if (move.pieceMoved->getID() == "bK") {
-        blackKingLocation = move.end;
+
+    // Hash the new castling rights, en passant target and active color
+    key ^= ZobristCastling[castlingRights.toMask()] ^ ZobristSide;
+    if (enPassantSquare != -1) {
+        key ^= ZobristEnPassant[fileOf(enPassantSquare)];
     }
 }
 
-std::tuple<bool, std::vector<Pin>, std::vector<Check> > Board::getPinsAndChecks() {
-    // Initialize vectors for pins, checks, and boolean value for inCheck
-    bool inCheck = false;
-    std::vector<Pin> pins;
-    std::vector<Check> checks;
+void Board::unmakeMove(Move move) {
+    // The side that made the move is the one not to play now
+    if (whiteToPlay) {
+        undoMove<BLACK>(move);
+    }
+    else {
+        undoMove<WHITE>(move);
+    }
+}
 
-    char enemyColor = (whiteToPlay) ? 'b' : 'w';
-    char allyColor = (whiteToPlay) ? 'w' : 'b';
+template<Color Us>
+void Board::undoMove(Move move) {
+    const int OurRank = (Us == WHITE) ? 7 : 0;
 
-    int startRow = (whiteToPlay) ? std::get<0>(whiteKingLocation) : std::get<0>(blackKingLocation);
-    int startCol = (whiteToPlay) ? std::get<1>(whiteKingLocation) : std::get<1>(blackKingLocation);
+    UndoInfo undo = undoStack.back();
+    undoStack.pop_back();
 
-    // Directions of possible pins and checks, excluding knights
-    std::vector<std::tuple<int, int> > directions;
-    // diretions for queens & bishops
-    directions.push_back(std::make_tuple(1, 1));
-    directions.push_back(std::make_tuple(1, -1));
-    directions.push_back(std::make_tuple(-1, 1));
-    directions.push_back(std::make_tuple(-1, -1));
-    // directions for queens & rooks
-    directions.push_back(std::make_tuple(1, 0));
-    directions.push_back(std::make_tuple(0, 1));
-    directions.push_back(std::make_tuple(-1, 0));
-    directions.push_back(std::make_tuple(0, -1));
+    int from = move.from();
+    int to = move.to();
 
-    // Iterate over directions for bishops, rooks, queens, and pawns
-    for (int j = 0; j < directions.size(); j++) {
+    // Change active color back. The move number was incremented if black made the move
+    whiteToPlay = (Us == WHITE);
+    if (Us == BLACK) {
+        moveNumber--;
+    }
 
-        std::tuple<int, int> dir = directions[j];
-        std::vector<int> possiblePin;
+    // Put the castled rook back in the corner
+    if (move.isCastle()) {
+        int rookFrom = (move.flag() == KING_CASTLE) ? squareIndex(OurRank, 7) : squareIndex(OurRank, 0);
+        int rookTo = (move.flag() == KING_CASTLE) ? squareIndex(OurRank, 5) : squareIndex(OurRank, 3);
+        movePiece(rookTo, rookFrom);
+    }
 
-        // Setup possible pin - can not be on squares (-1, -1) and is used for error checking
-        Pin pin(-1, -1, -1, -1);
+    // A promoted piece turns back into the pawn that promoted
+    if (move.isPromotion()) {
+        removePiece(to);
+        putPiece(makePiece(Us, PAWN), to);
+    }
 
-        // Radiate outward from current king position
-        for (int i = 1; i < 8; i++) {
+    // Move the piece back to its starting square
+    movePiece(to, from);
 
-            // Square an attacking piece could be
-            int endRow = startRow + std::get<0>(dir) * i;
-            int endCol = startCol + std::get<1>(dir) * i;
+    // Put back the captured piece. En passant captured the pawn beside the starting square
+    if (undo.captured != NO_PIECE) {
+        int captureSquare = move.isEnPassant() ? squareIndex(rankOf(from), fileOf(to)) : to;
+        putPiece(undo.captured, captureSquare);
+    }
 
-            // Bounds checking
-            if (0 <= endRow && endRow <= 7 && 0 <= endCol && endCol <= 7) {
-                BasePiece* endPiece = board[endRow][endCol].getPiece();
+    // Restoring king locations
+    if (mailbox[from] == makePiece(Us, KING)) {
+        ((Us == WHITE) ? whiteKingLocation : blackKingLocation) = move.getStart();
+    }
 
-                // If square is empty, move to next square in progression
-                if (endPiece == nullptr) {
-                    continue;
-                }
-                // If endPiece is opposite color and not a King, create a pin on that square as this piece could be attacking king
-                else if (endPiece->getID()[0] == allyColor && endPiece->getID() != "K") {
-                    if (possiblePin.size() == 0) {
-                        pin = Pin(endRow, endCol, std::get<0>(dir), std::get<1>(dir));
-                    }
-                    else {
-                        break;
-                    }
-                }
-                // If piece is opposite color, check if it is directly checking king or is pinning another piece
-                else if (endPiece->getID()[0] == enemyColor) {
-                    char enemyType = endPiece->getID()[1];
-
-                    /*
-                    The directions vector is setup such that the first 4 elements are the directions bishops and queens can move in.
-                    The last 4 elements are the directions queens and rooks can move in. 
-                    This if statement checks the type of piece is compatible with the current direction.
-                    */
-                    if ((0 <= j && j <= 3 && enemyType == 'B') || 
-                    (i == 1 && enemyType == 'p' && (enemyColor == 'w' && 0 <= i && i <= 1) || (enemyColor == 'b' && 2 <= j && j <= 3)) || 
-                    (enemyType == 'Q') || (i == 1 && enemyType == 'K') ||
-                    (4 <= j && j <= 7 && enemyType == 'R')) {
-
-                        // If pin is not possible, that means endPiece is checking the king
-                        if (pin.endRow == -1) {
-                            inCheck = true;
-                            Check check(endRow, endCol, std::get<0>(dir), std::get<1>(dir));
-                            checks.push_back(check);
-                            break;
-                        }
-                        // If the pin has been assigned a real value, there is a pin
-                        else {
-                            pins.push_back(pin);
-                            break;
-                        }
-                    }
-                    else {
-                        break;
-                    }
-                }
-            }
-            else {
-                break;
-            }
-        }
+    castlingRights = undo.castlingRights;
+    enPassantSquare = undo.enPassantSquare;
+    halfMove = undo.halfMove;
+    key = undo.key;
+}
+
+void Board::makeNullMove() {
+    UndoInfo undo;
+    undo.captured = NO_PIECE;
+    undo.castlingRights = castlingRights;
+    undo.enPassantSquare = enPassantSquare;
+    undo.halfMove = halfMove;
+    undo.key = key;
+    undoStack.push_back(undo);
+
+    if (enPassantSquare != -1) {
+        key ^= ZobristEnPassant[fileOf(enPassantSquare)];
+        enPassantSquare = -1;
     }
+    key ^= ZobristSide;
+    whiteToPlay = !whiteToPlay;
+    halfMove = 0;
+}
 
-    // Knights move in an 'L' pattern and do not follow same rules for algorithm above
-    // Knights also can not pin another piece
-    std::vector<std::tuple<int, int> > knightDirections;
-    knightDirections.push_back(std::make_tuple(2, 1));
-    knightDirections.push_back(std::make_tuple(1, 2));
-    knightDirections.push_back(std::make_tuple(-1, 2));
-    knightDirections.push_back(std::make_tuple(-2, 1));
-    knightDirections.push_back(std::make_tuple(-2, -1));
-    knightDirections.push_back(std::make_tuple(-1, -2));
-    knightDirections.push_back(std::make_tuple(1, -2));
-    knightDirections.push_back(std::make_tuple(2, -1));
-
-    for (std::tuple<int, int> move : knightDirections) {
-        int endRow = startRow + std::get<0>(move);
-        int endCol = startCol + std::get<1>(move);
-        
-        // Bounds checking
-        if (0 <= endRow && endRow <= 7 && 0 <= endCol && endCol <= 7) {
-            BasePiece* endPiece = board[endRow][endCol].getPiece();
-            // Continue if this square is empty
-            if (endPiece == nullptr) {
-                continue;
-            }
-            // If the piece is a knight, the knight is checking the king as knights can not pin pieces.
-            if (endPiece->getID()[0] == enemyColor && endPiece->getID()[1] == 'N') {
-                inCheck = true;
-                checks.push_back(Check(endRow, endCol, std::get<0>(move), std::get<1>(move)));
-            }
+void Board::unmakeNullMove() {
+    UndoInfo undo = undoStack.back();
+    undoStack.pop_back();
+
+    whiteToPlay = !whiteToPlay;
+    enPassantSquare = undo.enPassantSquare;
+    halfMove = undo.halfMove;
+    key = undo.key;
+}
+
+Key Board::computeKey() const {
+    Key k = 0;
+    Bitboard occupied = occupiedBB;
+    while (occupied) {
+        int sq = popLSB(occupied);
+        k ^= ZobristPieces[mailbox[sq]][sq];
+    }
+    k ^= ZobristCastling[castlingRights.toMask()];
+    if (enPassantSquare != -1) {
+        k ^= ZobristEnPassant[fileOf(enPassantSquare)];
+    }
+    if (!whiteToPlay) {
+        k ^= ZobristSide;
+    }
+    return k;
+}
+
+std::tuple<bool, std::vector<Pin>, std::vector<Check> > Board::getPinsAndChecks() {
+    // Initialize vectors for pins, checks, and boolean value for inCheck
+    std::vector<Pin> pins;
+    std::vector<Check> checks;
+
+    Color us = whiteToPlay ? WHITE : BLACK;
+    int kingSq = lsb(pieceBB[us][KING]);
+    int kingRow = rankOf(kingSq);
+    int kingCol = fileOf(kingSq);
+
+    // Direction from the king to a square on one of its lines, one step at a time
+    auto sign = [](int x) { return (x > 0) - (x < 0); };
+
+    // Every piece attacking the king is a check. Knights store their jump instead of a direction
+    Bitboard checkers = getCheckers();
+    while (checkers) {
+        int sq = popLSB(checkers);
+        int dRow = rankOf(sq) - kingRow;
+        int dCol = fileOf(sq) - kingCol;
+        if (typeOf(mailbox[sq]) != KNIGHT) {
+            dRow = sign(dRow);
+            dCol = sign(dCol);
         }
+        checks.push_back(Check(rankOf(sq), fileOf(sq), dRow, dCol));
     }
 
+    // Every piece of ours that is the only piece between the king and an enemy slider is pinned
+    Bitboard pinned = (us == WHITE) ? pinnedPieces<WHITE>() : pinnedPieces<BLACK>();
+    while (pinned) {
+        int sq = popLSB(pinned);
+        pins.push_back(Pin(rankOf(sq), fileOf(sq), sign(rankOf(sq) - kingRow), sign(fileOf(sq) - kingCol)));
+    }
+
+    bool inCheck = !checks.empty();
     std::tuple<bool, std::vector<Pin>, std::vector<Check> > pinsAndChecks = std::make_tuple(inCheck, pins, checks);
     return pinsAndChecks;
 }
 
+Bitboard Board::getCheckers() const {
+    Color us = whiteToPlay ? WHITE : BLACK;
+    return attackersTo(lsb(pieceBB[us][KING]), ~us);
+}
 
+bool Board::inCheck() const {
+    return getCheckers() != 0;
+}
 
-bool Board::squareUnderAttack(Square& square) {
-    // Change turns and get opposing color moves
-    whiteToPlay = !whiteToPlay;
-    std::vector<Move> opponentMoves = getAttackingMoves();
-    whiteToPlay = !whiteToPlay;
-
-    // Loop through moves and see if a move ends on that square
-    for (Move move : opponentMoves) {
-        // Squares pawns land on are not "under attack" if they are not diagonal
-        if (move.pieceMoved->getID()[1] != 'p') {
-            if (move.end == square.getLocation()) {
-                return true;
-            }
-        }
-        else {
-            if (std::get<1>(move.start) != std::get<1>(move.end)) {
-                if (move.end == square.getLocation()) {
-                    return true;
-                }
-            }
+bool Board::isRepetition() const {
+    // The undo stack holds the key before each move. Positions with the same side to play are every second
+    // entry, starting two moves back
+    int end = std::max(0, int(undoStack.size()) - halfMove);
+    for (int i = int(undoStack.size()) - 2; i >= end; i -= 2) {
+        if (undoStack[i].key == key) {
+            return true;
         }
     }
     return false;
 }
 
-
-bool Board::getWhiteToPlay() {
-    return whiteToPlay;
+template<Color Us>
+Bitboard Board::pinnedPieces() const {
+    const Color Them = (Us == WHITE) ? BLACK : WHITE;
+    int kingSq = lsb(pieceBB[Us][KING]);
+
+    // Enemy sliders that would attack the king on an empty board
+    Bitboard snipers = (rookAttacks(kingSq, 0) & (pieceBB[Them][ROOK] | pieceBB[Them][QUEEN]))
+                     | (bishopAttacks(kingSq, 0) & (pieceBB[Them][BISHOP] | pieceBB[Them][QUEEN]));
+    Bitboard pinned = 0;
+    while (snipers) {
+        Bitboard blockers = betweenBB(kingSq, popLSB(snipers)) & occupiedBB;
+        if (popCount(blockers) == 1) {
+            pinned |= blockers & colorBB[Us];
+        }
+    }
+    return pinned;
 }
 
-int Board::getHalfMove() {
-    return halfMove;
-}
 
-int Board::getMoveNumber() {
-    return moveNumber;
+bool Board::squareUnderAttack(const Square& square) {
+    int sq = squareIndex(std::get<0>(square.getLocation()), std::get<1>(square.getLocation()));
+    return isAttacked(sq, whiteToPlay ? BLACK : WHITE);
 }
 
-CastlingRights Board::getCastlingRights() {
-    return castlingRights;
+Bitboard Board::attackersTo(int sq, Bitboard occupied) const {
+    // Attacks are symmetric: a piece on sq attacks the squares its attackers of the same type stand on.
+    // Pawns are the exception, a white pawn attacks sq from where a black pawn on sq would attack
+    return (pawnAttacks(BLACK, sq) & pieceBB[WHITE][PAWN])
+         | (pawnAttacks(WHITE, sq) & pieceBB[BLACK][PAWN])
+         | (knightAttacks(sq) & (pieceBB[WHITE][KNIGHT] | pieceBB[BLACK][KNIGHT]))
+         | (kingAttacks(sq) & (pieceBB[WHITE][KING] | pieceBB[BLACK][KING]))
+         | (bishopAttacks(sq, occupied) & (pieceBB[WHITE][BISHOP] | pieceBB[BLACK][BISHOP] | pieceBB[WHITE][QUEEN] | pieceBB[BLACK][QUEEN]))
+         | (rookAttacks(sq, occupied) & (pieceBB[WHITE][ROOK] | pieceBB[BLACK][ROOK] | pieceBB[WHITE][QUEEN] | pieceBB[BLACK][QUEEN]));
 }
 
-std::string Board::getEnPassantTargets() {
-    return enPassantTargets;
+Bitboard Board::attackersTo(int sq, Color c) const {
+    return attackersTo(sq, occupiedBB) & colorBB[c];
 }
 
-Square& Board::getSquare(std::tuple<int, int> loc) {
-    return board[std::get<0>(loc)][std::get<1>(loc)];
+bool Board::isAttacked(int sq, Color c) const {
+    return (c == WHITE) ? isAttackedBy<WHITE>(sq) : isAttackedBy<BLACK>(sq);
 }
 
-std::vector<Move> Board::generateAllMoves() {
+template<Color Them>
+bool Board::isAttackedBy(int sq) const {
+    const Color Us = (Them == WHITE) ? BLACK : WHITE;
+    // Cheapest lookups first, so most attacked squares return before the slider lookups
+    return (pawnAttacks(Us, sq) & pieceBB[Them][PAWN])
+        || (knightAttacks(sq) & pieceBB[Them][KNIGHT])
+        || (kingAttacks(sq) & pieceBB[Them][KING])
+        || (bishopAttacks(sq, occupiedBB) & (pieceBB[Them][BISHOP] | pieceBB[Them][QUEEN]))
+        || (rookAttacks(sq, occupiedBB) & (pieceBB[Them][ROOK] | pieceBB[Them][QUEEN]));
+}
 
-    std::vector<Move> moves;
 
-    // Used to determine which pieces can move
-    std::tuple<bool, std::vector<Pin>, std::vector<Check> > pinsAndChecks = getPinsAndChecks();
-    char enemyColor = (getWhiteToPlay()) ? 'b' : 'w';
+PieceType Board::popLeastValuableAttacker(int sq, Bitboard stmAttackers, Color stm, Bitboard& occupied,
+    Bitboard& attackers) const {
+    PieceType pt = PAWN;
+    while (!(stmAttackers & pieceBB[stm][pt])) {
+        pt = PieceType(pt + 1);
+    }
+    occupied ^= squareBB(lsb(stmAttackers & pieceBB[stm][pt]));
 
-    for (std::vector<Square> rank : board) {
-        for (Square square : rank) {
-            if (square.getPiece() != nullptr && square.getPiece()->getID()[0] != enemyColor) {
-                std::vector<Move> pieceMoves = square.getPiece()->getValidMoves(this);
-                moves.insert(moves.end(), pieceMoves.begin(), pieceMoves.end());
-            }
-        }
+    // Taking a piece off the square's lines can uncover a slider behind it. Knights and kings hide nothing
+    if (pt == PAWN || pt == BISHOP || pt == QUEEN) {
+        attackers |= bishopAttacks(sq, occupied) & (pieceBB[WHITE][BISHOP] | pieceBB[BLACK][BISHOP]
+            | pieceBB[WHITE][QUEEN] | pieceBB[BLACK][QUEEN]);
     }
-    return moves;
+    if (pt == ROOK || pt == QUEEN) {
+        attackers |= rookAttacks(sq, occupied) & (pieceBB[WHITE][ROOK] | pieceBB[BLACK][ROOK]
+            | pieceBB[WHITE][QUEEN] | pieceBB[BLACK][QUEEN]);
+    }
+    attackers &= occupied;
+    return pt;
 }
 
-std::vector<Move> Board::generateMoves() {
-    std::vector<Move> moves;
+int Board::see(Move move) const {
+    if (move.isCastle()) {
+        return 0;
+    }
 
-    // Used to determine which pieces can move
-    std::tuple<bool, std::vector<Pin>, std::vector<Check> > pinsAndChecks = getPinsAndChecks();
-    char enemyColor = (getWhiteToPlay()) ? 'b' : 'w';
-    
-    int kingRow, kingCol;
-    // Get king locations for check validation
-    if (whiteToPlay) {
-        kingRow = std::get<0>(whiteKingLocation);
-        kingCol = std::get<1>(whiteKingLocation);
+    int from = move.from();
+    int to = move.to();
+    int captureSquare = move.isEnPassant() ? squareIndex(rankOf(from), fileOf(to)) : to;
+
+    // A pawn taking part in an exchange on the first or last rank promotes, recaptures included. The move
+    // promotes to the piece it names, a recapturing pawn to a queen
+    bool promotionSquare = rankOf(to) == 0 || rankOf(to) == 7;
+
+    Bitboard occupied = (occupiedBB ^ squareBB(from) ^ squareBB(captureSquare)) | squareBB(to);
+    Bitboard attackers = attackersTo(to, occupied) & occupied;
+    Color stm = colorOf(mailbox[from]);
+
+    // gain[d] is what the side making capture d has won if the exchange stopped there. At most 32 pieces can
+    // take part, so the list fits on the stack
+    int gain[32];
+    int d = 0;
+    gain[0] = (mailbox[captureSquare] == NO_PIECE) ? 0 : PieceValue[typeOf(mailbox[captureSquare])];
+    int onSquare = PieceValue[typeOf(mailbox[from])];
+    if (move.isPromotion()) {
+        gain[0] += PieceValue[move.promotionType()] - PieceValue[PAWN];
+        onSquare = PieceValue[move.promotionType()];
     }
-    else {
-        kingRow = std::get<0>(blackKingLocation);
-        kingCol = std::get<1>(blackKingLocation);
-    }
-
-    // King is in check
-    if (std::get<0>(pinsAndChecks)) {
-        // If only one piece is checking king, need to move king or capture checking piece or block check
-        if (std::get<2>(pinsAndChecks).size() == 1) {
-            std::vector<Move> allMoves = generateAllMoves();
-            Check check = std::get<2>(pinsAndChecks)[0];
-            // Get piece checking
-            BasePiece* pieceChecking = board[check.endRow][check.endCol].getPiece();
-            std::vector<std::tuple<int, int> > validSquares;
-
-            if (pieceChecking->getID()[1] == 'N') {
-                validSquares.push_back(std::make_tuple(check.endRow, check.endCol));
-            }
-            else {
-                for (int i = 1; i < 8; i++) {
-                    std::tuple<int, int> validSquare = std::make_tuple(kingRow + check.dirRow * i, kingCol + check.dirCol * i);
-                    validSquares.push_back(validSquare);
 
-                    if (std::get<0>(validSquare) == check.endRow && std::get<1>(validSquare) == check.endCol) {
-                        break;
-                    }
-                }
-            for (int i = allMoves.size() - 1; i > -1 ; i--) {
-                    if (allMoves[i].pieceMoved->getID()[1] != 'K') {
-                        if (std::count(validSquares.begin(), validSquares.end(), allMoves[i].end)) {
-                            allMoves.erase(allMoves.begin() + i);      
-                        }
-                    }
-                }
-            }
+    while (true) {
+        stm = ~stm;
+        Bitboard stmAttackers = attackers & colorBB[stm];
+        if (!stmAttackers) {
+            break;
         }
-
+        // The king can only recapture if the opponent has nothing left to take it with
+        if (!(stmAttackers & ~pieceBB[stm][KING]) && (attackers & colorBB[~stm])) {
+            break;
+        }
+        d++;
+        PieceType pt = popLeastValuableAttacker(to, stmAttackers, stm, occupied, attackers);
+        int promotion = (pt == PAWN && promotionSquare) ? PieceValue[QUEEN] - PieceValue[PAWN] : 0;
+        gain[d] = onSquare + promotion - gain[d - 1];
+        onSquare = PieceValue[pt] + promotion;
     }
 
-    for (std::vector<Square> rank : board) {
-        for (Square square : rank) {
-            if (square.getPiece() != nullptr && square.getPiece()->getID()[0] != enemyColor) {
-                std::vector<Move> pieceMoves = square.getPiece()->getValidMoves(this);
-                moves.insert(moves.end(), pieceMoves.begin(), pieceMoves.end());
-            }
-        }
+    // Each side stops recapturing as soon as going on would lose, so the best stopping point is found backwards
+    for (; d > 0; d--) {
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
     }
-    return moves;
+    return gain[0];
 }
 
-std::vector<Move> Board::getAttackingMoves() {
-    std::vector<Move> moves;
-    char enemyColor = (getWhiteToPlay()) ? 'b' : 'w';
-
-    for (std::vector<Square> rank : board) {
-        for (Square square : rank) {
-            if (square.getPiece() != nullptr && square.getPiece()->getID()[0] != enemyColor && square.getPiece()->getID()[1] == 'p') {
-                std::vector<Move> pieceMoves = square.getPiece()->getAttackingMoves(this);
-                moves.insert(moves.end(), pieceMoves.begin(), pieceMoves.end());
-            }
-            else if (square.getPiece() != nullptr && square.getPiece()->getID()[0] != enemyColor && square.getPiece()->getID()[1] != 'p') {
-                std::vector<Move> pieceMoves = square.getPiece()->getValidMoves(this);
-                moves.insert(moves.end(), pieceMoves.begin(), pieceMoves.end());
-            }
-        }
+bool Board::seeGE(Move move, int threshold) const {
+    if (move.isCastle()) {
+        return threshold <= 0;
     }
 
-    return moves;
-}
+    int from = move.from();
+    int to = move.to();
 
+    // Pawns promoting along the way change the value of the piece at stake, which the running balance below
+    // does not follow. Exchanges on the first and last ranks are rare enough to take the full swap list
+    if (rankOf(to) == 0 || rankOf(to) == 7) {
+        return see(move) >= threshold;
+    }
+    int captureSquare = move.isEnPassant() ? squareIndex(rankOf(from), fileOf(to)) : to;
 
-/*
-This method is from the Queen class and is here as Board is forward declared in BasePiece
-*/
-std::vector<Move> Queen::getValidMoves(Board* board) {
-    std::vector<Move> moves;
+    // What the move wins if it is not recaptured must reach the threshold, and what it wins if the moved piece is
+    // then lost for nothing must not: otherwise the answer is known before looking at the exchange
+    int swap = ((mailbox[captureSquare] == NO_PIECE) ? 0 : PieceValue[typeOf(mailbox[captureSquare])]) - threshold;
+    if (swap < 0) {
+        return false;
+    }
+    swap = PieceValue[typeOf(mailbox[from])] - swap;
+    if (swap <= 0) {
+        return true;
+    }
 
-    // Iterate over directions looking for valid moves
-    for (std::tuple<int, int> dir : directions) {
-        for (int i = 1; i < 8; i++) {
+    Bitboard occupied = (occupiedBB ^ squareBB(from) ^ squareBB(captureSquare)) | squareBB(to);
+    Bitboard attackers = attackersTo(to, occupied) & occupied;
+    Color stm = colorOf(mailbox[from]);
+
+    // res is 1 while the side that made the move is ahead of the threshold. Each side in turn recaptures with
+    // its least valuable attacker; swap is the balance the side to recapture must beat for the exchange to turn
+    int res = 1;
+    while (true) {
+        stm = ~stm;
+        Bitboard stmAttackers = attackers & colorBB[stm];
+        if (!stmAttackers) {
+            break;
+        }
+        res ^= 1;
 
-            // Ending coordinates of move
-            int endRow = std::get<0>(position) + std::get<0>(dir) * i;
-            int endCol = std::get<1>(position) + std::get<1>(dir) * i;
-            std::tuple<int, int> end = std::make_tuple(endRow, endCol);
+        PieceType pt = popLeastValuableAttacker(to, stmAttackers, stm, occupied, attackers);
+        if (pt == KING) {
+            // The king can only recapture if the opponent has nothing left to take it with
+            return (attackers & colorBB[~stm]) ? res ^ 1 : res;
+        }
+        if ((swap = PieceValue[pt] - swap) < res) {
+            break;
+        }
+    }
 
-            // Error checking bounds making sure move ends on board
-            if (0 <= endRow && endRow < 8 && 0 <= endCol && endCol < 8) {
+    return res != 0;
+}
 
-                // Checking if (endRow, endCol) is empty
-                if (board[0][endRow][endCol].getPiece() == nullptr) {
-                    Move move(position, end, this, board[0][endRow][endCol].getPiece());
-                    moves.push_back(move);
-                }
+bool Board::getWhiteToPlay() const {
+    return whiteToPlay;
+}
 
-                // If not empty, piece must be other color. Can not move beyond that piece
-                else if (board[0][endRow][endCol].getPiece()->getID()[0] != this->getID()[0]) {
-                    Move move(position, end, this, board[0][endRow][endCol].getPiece());
-                    moves.push_back(move);
-                    break;
-                }
+int Board::getHalfMove() const {
+    return halfMove;
+}
 
-                // If piece is same color, stop looking for moves in this direction
-                else {
-                    break;
-                }
-            }         
-        }
-    }
-    return moves;
+int Board::getMoveNumber() {
+    return moveNumber;
 }
 
-std::vector<Move> Queen::getAttackingMoves(Board* board) {
-    return getValidMoves(board);
+CastlingRights Board::getCastlingRights() {
+    return castlingRights;
 }
 
-/*
-This method is from the King class and is here as Board is forward declared in BasePiece
-*/
-std::vector<Move> King::getValidMoves(Board* board) {
-    std::vector<Move> moves;
-    char allyColor = (board->getWhiteToPlay()) ? 'w' : 'b';
-    // Iterate over directions looking for valid moves
-    for (std::tuple<int, int> dir : directions) {
+std::string Board::getEnPassantTargets() {
+    return (enPassantSquare == -1) ? "-" : squareName(enPassantSquare);
+}
 
-        // Ending coordinates of move
-        int endRow = std::get<0>(position) + std::get<0>(dir);
-        int endCol = std::get<1>(position) + std::get<1>(dir);
-        std::tuple<int, int> end = std::make_tuple(endRow, endCol);
+Square Board::getSquare(std::tuple<int, int> loc) {
+    return Square(std::get<0>(loc), std::get<1>(loc), mailbox[squareIndex(std::get<0>(loc), std::get<1>(loc))]);
+}
 
-        // Error checking bounds making sure move ends on board
-        if (0 <= endRow && endRow < 8 && 0 <= endCol && endCol < 8) {
+void Board::generateAllMoves(MoveList& moves) {
 
-            // Checking if (endRow, endCol) is empty
-            if (board[0][endRow][endCol].getPiece() == nullptr) {
-                Move move(position, end, this, board[0][endRow][endCol].getPiece());
-                moves.push_back(move);
-            }
+    moves.clear();
+    Color us = whiteToPlay ? WHITE : BLACK;
 
-            // If not empty, piece must be other color. Can not move beyond that piece
-            else if (board[0][endRow][endCol].getPiece()->getID()[0] != this->getID()[0]) {
-                Move move(position, end, this, board[0][endRow][endCol].getPiece());
-                moves.push_back(move);
-                break;
-            }
-        }  
+    // Only visit the squares holding a piece of the side to play
+    Bitboard ours = colorBB[us];
+    while (ours) {
+        int sq = popLSB(ours);
+        generatePieceMoves(sq, moves);
     }
-
-    // Kings can also castle kingside and queenside
-    std::vector<Move> castlingMoves = getCastlingMoves(board);
-    moves.insert(moves.end(), castlingMoves.begin(), castlingMoves.end());
-    return moves;
-}
-
-std::vector<Move> King::getAttackingMoves(Board* board) {
-    return getValidMoves(board);
 }
 
-std::vector<Move> King::getCastlingMoves(Board* board) {
-    std::vector<Move> castlingMoves;
+void Board::generateMoves(MoveList& moves) {
+    moves.clear();
 
-    // If white is to play, get king and queenside castling moves, if possible
-    if (board->getWhiteToPlay()) {
-        if (board->getCastlingRights().whiteKingSide) {
-            std::vector<Move> kingSideCastle = getKingSideCastlingMoves(board);
-            castlingMoves.insert(castlingMoves.end(), kingSideCastle.begin(), kingSideCastle.end());
-        }
-        if (board->getCastlingRights().whiteQueenSide) {
-            std::vector<Move> queenSideCastle = getQueenSideCastlingMoves(board);
-            castlingMoves.insert(castlingMoves.end(), queenSideCastle.begin(), queenSideCastle.end());
-        }
+    if (whiteToPlay) {
+        generateLegalMoves<WHITE, GEN_ALL>(moves);
     }
-    // If black is to play, get king and queenside castling moves, if possible
     else {
-        if (board->getCastlingRights().blackKingSide) {
-            std::vector<Move> kingSideCastle = getKingSideCastlingMoves(board);
-            castlingMoves.insert(castlingMoves.end(), kingSideCastle.begin(), kingSideCastle.end());
-        }
-        if (board->getCastlingRights().blackQueenSide) {
-            std::vector<Move> queenSideCastle = getQueenSideCastlingMoves(board);
-            castlingMoves.insert(castlingMoves.end(), queenSideCastle.begin(), queenSideCastle.end());
-        }
+        generateLegalMoves<BLACK, GEN_ALL>(moves);
     }
-
-    return castlingMoves;
 }
 
-std::vector<Move> King::getKingSideCastlingMoves(Board* board) {
-    std::vector<Move> kingSideCastleMoves;
-    int kingRank = std::get<0>(position);
-    int kingFile = std::get<1>(position);
+void Board::generateCaptures(MoveList& moves) {
+    moves.clear();
 
-    // To castle kingside, the bishop's and knight's starting square on the kingside must be empty and not under attack
-    if (board[0][kingRank][kingFile + 1].getPiece() == nullptr && board[0][kingRank][kingFile + 2].getPiece() == nullptr) {
-        if (!board->squareUnderAttack(board[0][kingRank][kingFile + 1]) && !board->squareUnderAttack(board[0][kingRank][kingFile + 2])) {
-            std::tuple<int, int> kingEndSquare = std::make_tuple(kingRank, kingFile + 2);
-            Move kingSideCastleMove(position, kingEndSquare, this, board[0].getSquare(kingEndSquare).getPiece(), true);
-            kingSideCastleMoves.push_back(kingSideCastleMove);
-        }
+    if (whiteToPlay) {
+        generateLegalMoves<WHITE, GEN_CAPTURES>(moves);
+    }
+    else {
+        generateLegalMoves<BLACK, GEN_CAPTURES>(moves);
     }
-
-    return kingSideCastleMoves;
 }
 
-std::vector<Move> King::getQueenSideCastlingMoves(Board* board) {
-    std::vector<Move> queenSideCastleMoves;
-    int kingRank = std::get<0>(position);
-    int kingFile = std::get<1>(position);
+void Board::generateQuiets(MoveList& moves) {
+    moves.clear();
 
-    // To castle queenside, the queen's, bishop's, and knight's starting square on the queenside must be empty and not under attack
-    if (board[0][kingRank][kingFile - 1].getPiece() == nullptr && board[0][kingRank][kingFile - 2].getPiece() == nullptr && board[0][kingRank][kingFile - 3].getPiece() == nullptr) {
-        if (!board->squareUnderAttack(board[0][kingRank][kingFile - 1]) && !board->squareUnderAttack(board[0][kingRank][kingFile - 2]) && !board->squareUnderAttack(board[0][kingRank][kingFile - 3])) {
-            std::tuple<int, int> kingEndSquare = std::make_tuple(kingRank, kingFile - 2);
-            Move queenSideCastleMove(position, kingEndSquare, this, board[0].getSquare(kingEndSquare).getPiece(), true);
-            queenSideCastleMoves.push_back(queenSideCastleMove);
-        }
+    if (whiteToPlay) {
+        generateLegalMoves<WHITE, GEN_QUIETS>(moves);
+    }
+    else {
+        generateLegalMoves<BLACK, GEN_QUIETS>(moves);
     }
-
-    return queenSideCastleMoves;
 }
 
+template<Color Us, GenType Type>
+void Board::generateLegalMoves(MoveList& moves) {
+    const Color Them = (Us == WHITE) ? BLACK : WHITE;
+    // Pawns capturing en passant stand one rank behind the target square
+    const int Down = (Us == WHITE) ? 8 : -8;
+
+    int kingSq = lsb(pieceBB[Us][KING]);
+    Bitboard checkers = attackersTo(kingSq, occupiedBB) & colorBB[Them];
+
+    // Squares the pieces other than pawns may move to in this stage: enemy pieces for captures, empty squares for quiets
+    const Bitboard stageMask = (Type == GEN_CAPTURES) ? colorBB[Them] : (Type == GEN_QUIETS) ? ~occupiedBB : ~colorBB[Us];
+
+    // The king may go to any square the opponent does not attack. The king is taken off the board first,
+    // so a square behind it on the line of a checking slider counts as attacked
+    Bitboard kingTargets = kingAttacks(kingSq) & stageMask;
+    Bitboard withoutKing = occupiedBB ^ squareBB(kingSq);
+    while (kingTargets) {
+        int to = popLSB(kingTargets);
+        if (!(attackersTo(to, withoutKing) & colorBB[Them])) {
+            moves.push_back(Move(kingSq, to, (mailbox[to] == NO_PIECE) ? QUIET : CAPTURE));
+        }
+    }
 
-/*
-This method is from the Rook class and is here as Board is forward declared in BasePiece
-*/
-std::vector<Move> Rook::getValidMoves(Board* board) {
-    std::vector<Move> moves;
-    // Iterate over directions looking for valid moves
-    for (std::tuple<int, int> dir : directions) {
-        for (int i = 1; i < 8; i++) {
+    // In double check only the king can move
+    if (popCount(checkers) > 1) {
+        return;
+    }
 
-            // Ending coordinates of move
-            int endRow = std::get<0>(position) + std::get<0>(dir) * i;
-            int endCol = std::get<1>(position) + std::get<1>(dir) * i;
-            std::tuple<int, int> end = std::make_tuple(endRow, endCol);
+    // Castling is only possible out of check
+    if (Type != GEN_CAPTURES && !checkers) {
+        generateCastlingMoves<Us>(moves);
+    }
 
-            // Error checking bounds making sure move ends on board
-            if (0 <= endRow && endRow < 8 && 0 <= endCol && endCol < 8) {
+    // In check, the other pieces must capture the checking piece or block its line to the king
+    Bitboard checkMask = ~Bitboard(0);
+    if (checkers) {
+        int checkerSq = lsb(checkers);
+        checkMask = betweenBB(kingSq, checkerSq) | checkers;
+    }
 
-                // Checking if (endRow, endCol) is empty
-                if (board[0][endRow][endCol].getPiece() == nullptr) {
-                    Move move(position, end, this, board[0][endRow][endCol].getPiece());
-                    moves.push_back(move);
-                }
+    // A pinned piece can only move along the line through the king and its pinner
+    Bitboard pinned = pinnedPieces<Us>();
+    Bitboard targets = checkMask & stageMask;
+    auto legalTargets = [&](int sq) {
+        return (pinned & squareBB(sq)) ? (targets & lineBB(kingSq, sq)) : targets;
+    };
+
+    // Unpinned pawns all share the same targets and are generated as one set. Pawns pick their stage themselves,
+    // since promotions onto empty squares count as captures
+    Bitboard pawnTargets = checkMask & ~colorBB[Us];
+    generatePawnMoves<Us, Type>(pieceBB[Us][PAWN] & ~pinned, pawnTargets, moves);
+    Bitboard pinnedPawns = pieceBB[Us][PAWN] & pinned;
+    while (pinnedPawns) {
+        int sq = popLSB(pinnedPawns);
+        generatePawnMoves<Us, Type>(squareBB(sq), pawnTargets & lineBB(kingSq, sq), moves);
+    }
 
-                // If not empty, piece must be other color. Can not move beyond that piece
-                else if (board[0][endRow][endCol].getPiece()->getID()[0] != this->getID()[0]) {
-                    Move move(position, end, this, board[0][endRow][endCol].getPiece());
-                    moves.push_back(move);
-                    break;
-                }
+    // Each piece type is walked straight off its bitboard, so only squares holding our pieces are visited.
+    // A knight never moves along a line, so a pinned knight has no moves at all
+    Bitboard knights = pieceBB[Us][KNIGHT] & ~pinned;
+    while (knights) {
+        generateKnightMoves(popLSB(knights), targets, moves);
+    }
+    Bitboard bishops = pieceBB[Us][BISHOP];
+    while (bishops) {
+        int sq = popLSB(bishops);
+        generateBishopMoves(sq, legalTargets(sq), moves);
+    }
+    Bitboard rooks = pieceBB[Us][ROOK];
+    while (rooks) {
+        int sq = popLSB(rooks);
+        generateRookMoves(sq, legalTargets(sq), moves);
+    }
+    Bitboard queens = pieceBB[Us][QUEEN];
+    while (queens) {
+        int sq = popLSB(queens);
+        generateQueenMoves(sq, legalTargets(sq), moves);
+    }
 
-                // If piece is same color, stop looking for moves in this direction
-                else {
-                    break;
-                }
-            }         
+    // En passant removes two pawns from a line at once, so it can expose the king in ways the pin mask
+    // does not see. Each one is checked by looking for attackers of the king after the capture
+    if (Type != GEN_QUIETS && enPassantSquare != -1) {
+        int captureSquare = enPassantSquare + Down;
+        Bitboard attackers = pawnAttacks(Them, enPassantSquare) & pieceBB[Us][PAWN];
+        while (attackers) {
+            int from = popLSB(attackers);
+            Bitboard after = (occupiedBB ^ squareBB(from) ^ squareBB(captureSquare)) | squareBB(enPassantSquare);
+            if (!(attackersTo(kingSq, after) & colorBB[Them] & ~squareBB(captureSquare))) {
+                moves.push_back(Move(from, enPassantSquare, EN_PASSANT));
+            }
         }
     }
-    return moves;
 }
 
-std::vector<Move> Rook::getAttackingMoves(Board* board) {
-    return getValidMoves(board);
-}
+bool Board::isLegal(Move move) {
+    Color us = whiteToPlay ? WHITE : BLACK;
+    int from = move.from();
+    if (move.isNull() || mailbox[from] == NO_PIECE || colorOf(mailbox[from]) != us) {
+        return false;
+    }
 
-/*
-This method is from the Bishop class and is here as Board is forward declared in BasePiece
-*/
-std::vector<Move> Bishop::getValidMoves(Board* board) {
-    std::vector<Move> moves;
+    // The move must be one the piece can make, with the same flag
+    MoveList pieceMoves;
+    generatePieceMoves(from, pieceMoves);
+    if (!pieceMoves.contains(move)) {
+        return false;
+    }
 
-    // Iterate over directions looking for valid moves
-    for (std::tuple<int, int> dir : directions) {
-        for (int i = 1; i < 8; i++) {
+    // The generator does not check for castling out of check, nor for moves that leave the king attacked
+    if (move.isCastle() && inCheck()) {
+        return false;
+    }
+    makeMove(move);
+    bool legal = !isAttacked(lsb(pieceBB[us][KING]), ~us);
+    unmakeMove(move);
+    return legal;
+}
 
-            // Ending coordinates of move
-            int endRow = std::get<0>(position) + std::get<0>(dir) * i;
-            int endCol = std::get<1>(position) + std::get<1>(dir) * i;
-            std::tuple<int, int> end = std::make_tuple(endRow, endCol);
+uint64_t Board::perft(int depth) {
+    MoveList moves;
+    generateMoves(moves);
 
-            // Error checking bounds making sure move ends on board
-            if (0 <= endRow && endRow < 8 && 0 <= endCol && endCol < 8) {
+    // Every generated move is legal, so the last ply is counted without playing it
+    if (depth <= 1) {
+        return (depth == 1) ? moves.size() : 1;
+    }
 
-                // Checking if (endRow, endCol) is empty
-                if (board[0][endRow][endCol].getPiece() == nullptr) {
-                    Move move(position, end, this, board[0][endRow][endCol].getPiece());
-                    moves.push_back(move);
-                }
+    uint64_t nodes = 0;
+    for (Move move : moves) {
+        makeMove(move);
+        nodes += perft(depth - 1);
+        unmakeMove(move);
+    }
+    return nodes;
+}
 
-                // If not empty, piece must be other color. Can not move beyond that piece
-                else if (board[0][endRow][endCol].getPiece()->getID()[0] != this->getID()[0]) {
-                    Move move(position, end, this, board[0][endRow][endCol].getPiece());
-                    moves.push_back(move);
-                    break;
-                }
+void Board::getAttackingMoves(MoveList& moves) {
+    moves.clear();
+    Color us = whiteToPlay ? WHITE : BLACK;
 
-                // If piece is same color, stop looking for moves in this direction
-                else {
-                    break;
-                }
-            }         
-        }
+    // Pawns attack diagonally, kings attack the squares next to them (castling attacks nothing),
+    // every other piece attacks the squares it can move to
+    Bitboard ours = colorBB[us];
+    while (ours) {
+        int sq = popLSB(ours);
+        generatePieceAttackingMoves(sq, moves);
     }
-    return moves;
 }
 
-std::vector<Move> Bishop::getAttackingMoves(Board* board) {
-    return getValidMoves(board);
-}
 
-/*
-This method is from the Knight class and is here as Board is forward declared in BasePiece
-*/
-std::vector<Move> Knight::getValidMoves(Board* board) {
-    std::vector<Move> moves;
+void Board::generatePieceMoves(int sq, MoveList& moves) {
+    // Any square not holding a piece of its own color
+    Bitboard targets = ~colorBB[colorOf(mailbox[sq])];
 
-    // Iterate over directions looking for valid moves
-    for (std::tuple<int, int> dir : directions) {
-        for (int i = 1; i < 2; i++) {
+    switch (typeOf(mailbox[sq])) {
+        case PAWN:
+            if (colorOf(mailbox[sq]) == WHITE) {
+                generatePawnMoves<WHITE, GEN_ALL>(squareBB(sq), targets, moves);
+            }
+            else {
+                generatePawnMoves<BLACK, GEN_ALL>(squareBB(sq), targets, moves);
+            }
+            // The pawn that just passed this one can be captured en passant
+            if (enPassantSquare != -1 && (pawnAttacks(colorOf(mailbox[sq]), sq) & squareBB(enPassantSquare))) {
+                moves.push_back(Move(sq, enPassantSquare, EN_PASSANT));
+            }
+            break;
+        case KNIGHT: generateKnightMoves(sq, targets, moves); break;
+        case BISHOP: generateBishopMoves(sq, targets, moves); break;
+        case ROOK:   generateRookMoves(sq, targets, moves);   break;
+        case QUEEN:  generateQueenMoves(sq, targets, moves);  break;
+        case KING:   generateKingMoves(sq, moves);            break;
+        default:     break;
+    }
+}
 
-            // Ending coordinates of move
-            int endRow = std::get<0>(position) + std::get<0>(dir) * i;
-            int endCol = std::get<1>(position) + std::get<1>(dir) * i;
-            std::tuple<int, int> end = std::make_tuple(endRow, endCol);
+void Board::generatePieceAttackingMoves(int sq, MoveList& moves) {
+    Piece piece = mailbox[sq];
+
+    // Pawns attack both diagonals whether or not a piece stands there
+    if (typeOf(piece) == PAWN) {
+        Bitboard targets = pawnAttacks(colorOf(piece), sq);
+        while (targets) {
+            moves.push_back(Move(sq, popLSB(targets), CAPTURE));
+        }
+    }
+    // Castling never attacks a square, so it is left out here. Otherwise finding the squares attacked by
+    // the opponent's king would check its castling squares, which asks for this side's attacks again
+    else if (typeOf(piece) == KING) {
+        addMovesTo(sq, kingAttacks(sq) & ~colorBB[colorOf(piece)], moves);
+    }
+    else {
+        generatePieceMoves(sq, moves);
+    }
+}
 
-            // Error checking bounds making sure move ends on board
-            if (0 <= endRow && endRow < 8 && 0 <= endCol && endCol < 8) {
+void Board::addMovesTo(int from, Bitboard targets, MoveList& moves) {
+    while (targets) {
+        int to = popLSB(targets);
+        moves.push_back(Move(from, to, (mailbox[to] == NO_PIECE) ? QUIET : CAPTURE));
+    }
+}
 
-                // Checking if (endRow, endCol) is empty
-                if (board[0][endRow][endCol].getPiece() == nullptr) {
-                    Move move(position, end, this, board[0][endRow][endCol].getPiece());
-                    moves.push_back(move);
-                }
+/**
+ * @brief Adds a move to every square in tos from the square offset indices behind it.
+ * 
+ * @param tos - ending squares of the moves
+ * @param offset - ending square minus starting square
+ * @param flag - flag of every move
+ * @param moves - list the moves are added to
+ */
+static void addShiftedMoves(Bitboard tos, int offset, int flag, MoveList& moves) {
+    while (tos) {
+        int to = popLSB(tos);
+        moves.push_back(Move(to - offset, to, flag));
+    }
+}
 
-                // If not empty, piece must be other color. Can not move beyond that piece
-                else if (board[0][endRow][endCol].getPiece()->getID()[0] != this->getID()[0]) {
-                    Move move(position, end, this, board[0][endRow][endCol].getPiece());
-                    moves.push_back(move);
-                    break;
-                }
-            }         
+/**
+ * @brief Adds the four promotion moves to every square in tos from the square offset indices behind it.
+ * 
+ * @param tos - ending squares of the promoting pawns
+ * @param offset - ending square minus starting square
+ * @param flag - QUIET or CAPTURE
+ * @param moves - list the moves are added to
+ */
+static void addPromotions(Bitboard tos, int offset, int flag, MoveList& moves) {
+    while (tos) {
+        int to = popLSB(tos);
+        for (int promotion = KNIGHT_PROMOTION; promotion <= QUEEN_PROMOTION; promotion++) {
+            moves.push_back(Move(to - offset, to, promotion | flag));
         }
     }
-    return moves;
 }
 
-std::vector<Move> Knight::getAttackingMoves(Board* board) {
-    return getValidMoves(board);
+template<Color Us, GenType Type>
+void Board::generatePawnMoves(Bitboard pawns, Bitboard targets, MoveList& moves) {
+    const Color Them = (Us == WHITE) ? BLACK : WHITE;
+    // White pawns move up the board (towards rank 0), black pawns move down. Left and right are towards the a-file and h-file
+    const int Up = (Us == WHITE) ? -8 : 8;
+    const int UpLeft = (Us == WHITE) ? -9 : 7;
+    const int UpRight = (Us == WHITE) ? -7 : 9;
+    // The last rank, and the rank a pawn reaches after its first single step from the starting rank
+    const Bitboard LastRankBB = rankBB((Us == WHITE) ? 0 : 7);
+    const Bitboard ThirdRankBB = rankBB((Us == WHITE) ? 5 : 2);
+
+    // Pawns move forward onto empty squares, two squares if the pawn has not moved yet and both are empty
+    Bitboard empty = ~occupiedBB;
+    Bitboard singlePushes = shift<Up>(pawns) & empty;
+    Bitboard doublePushes = shift<Up>(singlePushes & ThirdRankBB) & empty & targets;
+    singlePushes &= targets;
+
+    // Pawns can only capture opposing pieces diagonally
+    Bitboard leftCaptures = shift<UpLeft>(pawns) & colorBB[Them] & targets;
+    Bitboard rightCaptures = shift<UpRight>(pawns) & colorBB[Them] & targets;
+
+    // Reaching the last rank promotes. Promotions change the material like captures do, so they belong to the capture stage
+    if (Type != GEN_QUIETS) {
+        addPromotions(singlePushes & LastRankBB, Up, QUIET, moves);
+        addPromotions(leftCaptures & LastRankBB, UpLeft, CAPTURE, moves);
+        addPromotions(rightCaptures & LastRankBB, UpRight, CAPTURE, moves);
+        addShiftedMoves(leftCaptures & ~LastRankBB, UpLeft, CAPTURE, moves);
+        addShiftedMoves(rightCaptures & ~LastRankBB, UpRight, CAPTURE, moves);
+    }
+    if (Type != GEN_CAPTURES) {
+        addShiftedMoves(singlePushes & ~LastRankBB, Up, QUIET, moves);
+        addShiftedMoves(doublePushes, 2 * Up, DOUBLE_PAWN_PUSH, moves);
+    }
 }
 
-std::vector<Move> Pawn::getValidMoves(Board* board) {
-    std::vector<Move> moves;
+void Board::generateKnightMoves(int sq, Bitboard targets, MoveList& moves) {
+    // Every square the knight jumps to within targets
+    addMovesTo(sq, knightAttacks(sq) & targets, moves);
+}
 
-    // Pawns can only move up board if white and down board if black
-    int moveAmount = (board->getWhiteToPlay()) ? -1 : 1;
-    int startRow = (board->getWhiteToPlay()) ? 6 : 1;
-    char enemyColor = (board->getWhiteToPlay()) ? 'b' : 'w';
+void Board::generateBishopMoves(int sq, Bitboard targets, MoveList& moves) {
+    // Every square the bishop attacks within targets
+    addMovesTo(sq, bishopAttacks(sq, occupiedBB) & targets, moves);
+}
 
-    // Pawns can only move forward
-    if (std::get<0>(position) + moveAmount <= 7 && std::get<0>(position) + moveAmount >= 0) {
-        // Square infront of pawn must be empty to move forward
-        if (board[0][std::get<0>(position) + moveAmount][std::get<1>(position)].getPiece() == nullptr) {
-            // Tuple of the ending square's position
-            std::tuple<int, int> end = std::make_tuple(std::get<0>(position) + moveAmount, std::get<1>(position));
-            Move move(position, end, this, board[0][std::get<0>(end)][std::get<1>(end)].getPiece());
-            moves.push_back(move);
+void Board::generateRookMoves(int sq, Bitboard targets, MoveList& moves) {
+    // Every square the rook attacks within targets
+    addMovesTo(sq, rookAttacks(sq, occupiedBB) & targets, moves);
+}
 
-            // Pawns can move forward two squares if pawn has not moved yet
-            if (std::get<0>(position) == startRow && board[0][std::get<0>(position) + (2 * moveAmount)][std::get<1>(position)].getPiece() == nullptr) {
-                std::tuple<int, int> endSq = std::make_tuple(std::get<0>(position) + (2 * moveAmount), std::get<1>(position));
-                Move twoSquarePawnMove(position, endSq, this, board[0][std::get<0>(position) + (2 * moveAmount)][std::get<1>(position)].getPiece());
-                moves.push_back(twoSquarePawnMove);
-            }
-        }   
+void Board::generateQueenMoves(int sq, Bitboard targets, MoveList& moves) {
+    // Every square the queen attacks within targets
+    addMovesTo(sq, queenAttacks(sq, occupiedBB) & targets, moves);
+}
 
-        // Pawns can only capture opposing pieces diagonally
+void Board::generateKingMoves(int sq, MoveList& moves) {
+    Color us = colorOf(mailbox[sq]);
 
-        // Capture to left
-        if (std::get<1>(position) - 1 >= 0) {
-            if (board[0][std::get<0>(position) + moveAmount][std::get<1>(position) - 1].getPiece() != nullptr && board[0][std::get<0>(position) + moveAmount][std::get<1>(position) - 1].getPiece()->getID()[0] == enemyColor) {
-                std::tuple<int, int> end = std::make_tuple(std::get<0>(position) + moveAmount, std::get<1>(position) - 1);
-                Move leftCapture(position, end, this, board[0][std::get<0>(position) + moveAmount][std::get<1>(position) - 1].getPiece());
-                moves.push_back(leftCapture);
-            }
-        }   
+    // Kings can move one square in any direction
+    addMovesTo(sq, kingAttacks(sq) & ~colorBB[us], moves);
 
-        // Capture to right
-        if (std::get<1>(position) + 1 <= 7) {
-            if (board[0][std::get<0>(position) + moveAmount][std::get<1>(position) + 1].getPiece() != nullptr && board[0][std::get<0>(position) + moveAmount][std::get<1>(position) + 1].getPiece()->getID()[0] == enemyColor) {
-                std::tuple<int, int> end = std::make_tuple(std::get<0>(position) + moveAmount, std::get<1>(position) + 1);
-                Move rightCapture(position, end, this, board[0][std::get<0>(position) + moveAmount][std::get<1>(position) + 1].getPiece());
-                moves.push_back(rightCapture);     
-            }      
-        }   
+    // Kings can also castle kingside and queenside
+    if (us == WHITE) {
+        generateCastlingMoves<WHITE>(moves);
+    }
+    else {
+        generateCastlingMoves<BLACK>(moves);
     }
-    return moves;
 }
 
-std::vector<Move> Pawn::getAttackingMoves(Board* board) {
-    std::vector<Move> moves;
-
-    // Pawns can only move up board if white and down board if black
-    int moveAmount = (board->getWhiteToPlay()) ? -1 : 1;
-    int startRow = (board->getWhiteToPlay()) ? 6 : 1;
-    char enemyColor = (board->getWhiteToPlay()) ? 'b' : 'w';
-
-    if (std::get<0>(position) + moveAmount <= 7 && std::get<0>(position) + moveAmount >= 0) {
-        // Pawns can only capture opposing pieces diagonally
+template<Color Us>
+void Board::generateCastlingMoves(MoveList& moves) {
+    const Color Them = (Us == WHITE) ? BLACK : WHITE;
+    const int KingSquare = (Us == WHITE) ? squareIndex(7, 4) : squareIndex(0, 4);
+    bool kingSide = (Us == WHITE) ? castlingRights.whiteKingSide : castlingRights.blackKingSide;
+    bool queenSide = (Us == WHITE) ? castlingRights.whiteQueenSide : castlingRights.blackQueenSide;
 
-        // Capture to left
-        if (std::get<1>(position) - 1 >= 0) {
-            std::tuple<int, int> end = std::make_tuple(std::get<0>(position) + moveAmount, std::get<1>(position) - 1);
-            Move leftCapture(position, end, this, board[0][std::get<0>(position) + moveAmount][std::get<1>(position) - 1].getPiece());
-            moves.push_back(leftCapture);
-        }   
+    // To castle kingside, the bishop's and knight's starting square on the kingside must be empty and not under attack
+    const Bitboard KingSideEmpty = squareBB(KingSquare + 1) | squareBB(KingSquare + 2);
+    if (kingSide && !(occupiedBB & KingSideEmpty)) {
+        if (!isAttackedBy<Them>(KingSquare + 1) && !isAttackedBy<Them>(KingSquare + 2)) {
+            moves.push_back(Move(KingSquare, KingSquare + 2, KING_CASTLE));
+        }
+    }
 
-        // Capture to right
-        if (std::get<1>(position) + 1 <= 7) {
-            std::tuple<int, int> end = std::make_tuple(std::get<0>(position) + moveAmount, std::get<1>(position) + 1);
-            Move rightCapture(position, end, this, board[0][std::get<0>(position) + moveAmount][std::get<1>(position) + 1].getPiece());
-            moves.push_back(rightCapture);     
-        }   
+    // To castle queenside, the queen's, bishop's, and knight's starting square on the queenside must be empty.
+    // Only the squares the king crosses must not be under attack, the knight's square may be
+    const Bitboard QueenSideEmpty = squareBB(KingSquare - 1) | squareBB(KingSquare - 2) | squareBB(KingSquare - 3);
+    if (queenSide && !(occupiedBB & QueenSideEmpty)) {
+        if (!isAttackedBy<Them>(KingSquare - 1) && !isAttackedBy<Them>(KingSquare - 2)) {
+            moves.push_back(Move(KingSquare, KingSquare - 2, QUEEN_CASTLE));
+        }
     }
-    return moves;
 }
 
 
-std::ostream& operator<<(std::ostream& os, const Move& move) {
-    Move m(move);
-    char piece = move.pieceMoved->getID()[1];
-    int rank = std::get<0>(m.end);
-    int file = std::get<1>(m.end);
-    std::string endingSquare = m.getRankFile(rank, file);
+std::string moveToAlgebraic(Board& board, Move move) {
+    if (move.isCastle()) {
+        return (move.flag() == KING_CASTLE) ? "O-O" : "O-O-O";
+    }
+
+    PieceType piece = typeOf(board.getPieceAt(move.from()));
+    std::string notation;
 
     // Pawn moves are denoted by the file and rank, not piece type
-    if (piece == 'p') {
-        // Pawn push
-        if (std::get<1>(m.start) - std::get<1>(m.end) == 0) {
-            os << m.getRankFile(rank, file);
+    if (piece == PAWN) {
+        if (move.isCapture()) {
+            notation += squareName(move.from())[0];
+            notation += 'x';
         }
-        else {
-            os << m.getRankFile(std::get<0>(m.start), std::get<1>(m.start))[0] << 'x' << m.getRankFile(rank, file);
+        notation += squareName(move.to());
+        if (move.isPromotion()) {
+            notation += '=';
+            notation += "NBRQ"[move.promotionType() - KNIGHT];
         }
     }
     else {
-        if (m.isCastleMove) {
-            if (std::get<1>(m.start) > file) {
-                os << "O-O";
-            }
-            else {
-                os << "O-O-O";
-            }
-            return os;
-        }
-        // No Capture
-        if (m.pieceCaptured == nullptr) {
-            os << piece << m.getRankFile(rank, file);
-        }
-        else {
-            os << piece << 'x' << m.getRankFile(rank, file);
+        notation += "pNBRQK"[piece];
+        if (move.isCapture()) {
+            notation += 'x';
         }
+        notation += squareName(move.to());
     }
-    return os;
-}
\ No newline at end of file
+    return notation;
+}
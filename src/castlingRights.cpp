@@ -63,4 +63,8 @@ std::string CastlingRights::toString() {
         castlingRights += "-";
     
     return castlingRights;
-}
\ No newline at end of file
+}
+
+int CastlingRights::toMask() const {
+    return (whiteKingSide ? 1 : 0) | (whiteQueenSide ? 2 : 0) | (blackKingSide ? 4 : 0) | (blackQueenSide ? 8 : 0);
+}
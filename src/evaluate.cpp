@@ -0,0 +1,12 @@
+#include "evaluate.h"
+
+#include <algorithm>
+
+
+int evaluate(const Board& board) {
+    // Blend the middlegame and endgame scores by how much material is left. The board keeps both sums up to
+    // date, so this does not look at the pieces
+    int phase = std::min(board.getPhase(), MAX_PHASE);
+    int score = (board.getMidgameScore() * phase + board.getEndgameScore() * (MAX_PHASE - phase)) / MAX_PHASE;
+    return board.getWhiteToPlay() ? score : -score;
+}
@@ -0,0 +1,32 @@
+#include "history.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+
+History::History() {
+    clear();
+}
+
+void History::clear() {
+    std::fill(&butterfly[0][0][0], &butterfly[0][0][0] + 2 * 64 * 64, 0);
+    std::fill(&pieceTo[0][0], &pieceTo[0][0] + 12 * 64, 0);
+    std::fill(&counterMoves[0][0], &counterMoves[0][0] + 12 * 64, Move());
+}
+
+void History::applyBonus(int& score, int bonus) {
+    score += bonus - score * std::abs(bonus) / MAX_HISTORY;
+}
+
+int History::score(Piece piece, Move move) const {
+    return butterfly[colorOf(piece)][move.from()][move.to()] + pieceTo[piece][move.to()];
+}
+
+void History::update(Piece piece, Move move, int bonus) {
+    applyBonus(butterfly[colorOf(piece)][move.from()][move.to()], bonus);
+    applyBonus(pieceTo[piece][move.to()], bonus);
+}
+
+int History::bonus(int depth) {
+    return std::min(depth * depth, 1200);
+}
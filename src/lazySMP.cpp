@@ -0,0 +1,53 @@
+#include "lazySMP.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+LazySMP::LazySMP(int threads, size_t hashMegabytes) : tt(hashMegabytes), threadCount(1), stopSignal(false) {
+    setThreads(threads);
+}
+
+void LazySMP::setThreads(int threads) {
+    threadCount = (threads > 1) ? threads : 1;
+}
+
+void LazySMP::setHashSize(size_t megabytes) {
+    tt.resize(megabytes);
+}
+
+SearchResult LazySMP::run(const Board& board, const SearchLimits& limits) {
+    stopSignal.store(false, std::memory_order_relaxed);
+    tt.newSearch();
+
+    // Every thread gets its own board and search stacks. Searches are large, so they live on the heap
+    std::vector<std::unique_ptr<Board> > boards;
+    std::vector<std::unique_ptr<Search> > searches;
+    for (int i = 0; i < threadCount; i++) {
+        boards.push_back(std::unique_ptr<Board>(new Board(board)));
+        searches.push_back(std::unique_ptr<Search>(new Search(*boards[i], tt, &stopSignal, i)));
+        searches[i]->setOptions(options);
+    }
+
+    // Helpers search without limits until the main thread is done
+    SearchLimits helperLimits;
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threadCount; i++) {
+        Search* search = searches[i].get();
+        helpers.push_back(std::thread([search, helperLimits]() { search->run(helperLimits); }));
+    }
+
+    SearchResult result = searches[0]->run(limits);
+
+    stop();
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+
+    for (int i = 1; i < threadCount; i++) {
+        result.nodes += searches[i]->getNodes();
+        result.tableStats += searches[i]->getTableStats();
+    }
+    return result;
+}
@@ -1,17 +1,139 @@
-
-//#include "basepiece.h"
 #include "board.h"
+#include "lazySMP.h"
+#include "search.h"
+#include "threadPool.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/*
+Time to depth of the Lazy SMP search with 1, 2, 4, ... threads up to the number of cores, over a few
+positions, each searched with an empty table.
+*/
+static void benchSMP(int depth) {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10"
+    };
+    int cores = std::max(1u, std::thread::hardware_concurrency());
+    SearchLimits limits;
+    limits.depth = depth;
+
+    double baseSeconds = 0;
+    for (int threads = 1; threads <= cores; threads *= 2) {
+        LazySMP smp(threads);
+        uint64_t nodes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const char* fen : fens) {
+            smp.getTable().clear(threads);
+            nodes += smp.run(Board(fen), limits).nodes;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (threads == 1) {
+            baseSeconds = seconds;
+        }
+        std::cout << "threads " << threads << " time " << seconds << "s speedup " << baseSeconds / seconds
+                  << " nodes " << nodes << " nps " << uint64_t(nodes / seconds) << std::endl;
+    }
+}
+
+/*
+Runs perft on every position of an EPD perft suite on a thread pool. Each line holds a FEN followed by
+the expected counts, as in "<FEN> ;D1 20 ;D2 400". Positions whose count at depth differs are printed.
+*/
+static int perftSuite(const char* path, int depth, int threads) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "can not open " << path << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty()) {
+            lines.push_back(line);
+        }
+    }
+
+    // Each task writes only its own slot, so the results need no lock
+    std::vector<uint64_t> counts(lines.size());
+    auto start = std::chrono::steady_clock::now();
+    ThreadPool pool(threads);
+    for (size_t i = 0; i < lines.size(); i++) {
+        std::string fen = lines[i].substr(0, lines[i].find(';'));
+        pool.submit([fen, depth, i, &counts]() {
+            Board board(fen);
+            counts[i] = board.perft(depth);
+        });
+    }
+    pool.wait();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int failed = 0;
+    uint64_t nodes = 0;
+    std::string expectedTag = ";D" + std::to_string(depth) + " ";
+    for (size_t i = 0; i < lines.size(); i++) {
+        nodes += counts[i];
+        size_t tag = lines[i].find(expectedTag);
+        if (tag != std::string::npos && std::stoull(lines[i].substr(tag + expectedTag.size())) != counts[i]) {
+            std::cout << "mismatch " << counts[i] << ": " << lines[i] << std::endl;
+            failed++;
+        }
+    }
+    std::cout << lines.size() << " positions, " << failed << " failed, " << nodes << " nodes in " << seconds
+              << "s on " << pool.size() << " threads" << std::endl;
+    return failed ? 1 : 0;
+}
+
+/*
+Searches a position and prints the result.
 
+Usage: main [FEN] [depth] [threads]. Searches the starting position to depth 5 on one thread by default.
+       main go <FEN> <movetime> [threads]. Searches for movetime milliseconds.
+       main bench [depth]. Prints the time to depth for each thread count, see benchSMP.
+       main perft <EPD file> <depth> [threads]. Checks a perft suite, see perftSuite.
+*/
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "bench") == 0) {
+        benchSMP((argc > 2) ? std::atoi(argv[2]) : 8);
+        return 0;
+    }
+    if (argc > 3 && std::strcmp(argv[1], "perft") == 0) {
+        return perftSuite(argv[2], std::atoi(argv[3]), (argc > 4) ? std::atoi(argv[4]) : 0);
+    }
 
-// Dummy main for compilation purposes
-int main() {
-    Board b("3rk3/8/8/8/8/8/8/3K4 w - - 0 1");
+    // Arguments after the mode: FEN, then the depth or the move time, then the thread count
+    bool timed = argc > 3 && std::strcmp(argv[1], "go") == 0;
+    int arg = timed ? 2 : 1;
+    Board b = (argc > arg) ? Board(argv[arg]) : Board();
+    SearchLimits limits;
+    if (timed) {
+        limits.movetime = std::atoll(argv[arg + 1]);
+    }
+    else {
+        limits.depth = (argc > arg + 1) ? std::atoi(argv[arg + 1]) : 5;
+    }
 
-    std::vector<Move> all = b.generateAllMoves();
-    std::vector<Move> moves = b.generateMoves();
+    LazySMP smp((argc > arg + 2) ? std::atoi(argv[arg + 2]) : 1);
+    auto start = std::chrono::steady_clock::now();
+    SearchResult result = smp.run(b, limits);
+    int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
 
-    std::cout << all.size() << std::endl << moves.size() << std::endl;
+    std::cout << "depth " << result.depth << " score " << result.score << " nodes " << result.nodes
+              << " time " << ms << "ms" << std::endl;
+    std::cout << "pv";
+    for (Move move : result.pv) {
+        std::cout << " " << move;
+    }
+    std::cout << std::endl << "bestmove " << result.bestMove << std::endl;
 
     return 0;
-}
\ No newline at end of file
+}
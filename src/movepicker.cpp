@@ -0,0 +1,139 @@
+#include "movepicker.h"
+
+
+MovePicker::MovePicker(Board& board, Move hashMove, Move killer1, Move killer2, Move counterMove,
+    const History* history) :
+    board(board), hashMove(hashMove), capturesOnly(false), history(history), stage(HASH_MOVE), current(0) {
+    // Checked only when their stage is reached, so a node cutting off early pays for no legality tests
+    refutations[0] = killer1;
+    refutations[1] = killer2;
+    refutations[2] = counterMove;
+}
+
+MovePicker::MovePicker(Board& board, bool capturesOnly) :
+    board(board), capturesOnly(capturesOnly), history(nullptr), stage(GENERATE_CAPTURES), current(0) {
+}
+
+int MovePicker::captureScore(Move move) const {
+    // Most valuable victim first, and among captures of the same victim the least valuable attacker first.
+    // Promotions are scored by the piece promoted to on top of any capture
+    int score = 0;
+    if (move.isCapture()) {
+        PieceType victim = move.isEnPassant() ? PAWN : typeOf(board.getPieceAt(move.to()));
+        PieceType attacker = typeOf(board.getPieceAt(move.from()));
+        score += 8 * (victim + 1) - attacker;
+    }
+    if (move.isPromotion()) {
+        score += 8 * move.promotionType();
+    }
+    return score;
+}
+
+Move MovePicker::pickBest() {
+    int best = current;
+    for (int i = current + 1; i < moves.size(); i++) {
+        if (scores[i] > scores[best]) {
+            best = i;
+        }
+    }
+    std::swap(moves[current], moves[best]);
+    std::swap(scores[current], scores[best]);
+    return moves[current++];
+}
+
+bool MovePicker::isValidRefutation(int i) const {
+    // Killers and countermoves are quiet moves from other positions. Ones that are captures here, repeat an
+    // earlier move or are not legal in this position are dropped. The cheap tests come first
+    Move move = refutations[i];
+    return !move.isNull() && move != hashMove && (i < 1 || move != refutations[0]) && (i < 2 || move != refutations[1])
+        && board.getPieceAt(move.to()) == NO_PIECE && !move.isPromotion() && !move.isEnPassant()
+        && board.isLegal(move);
+}
+
+bool MovePicker::alreadyReturned(Move move) const {
+    return move == hashMove || move == refutations[0] || move == refutations[1] || move == refutations[2];
+}
+
+Move MovePicker::next() {
+    switch (stage) {
+        case HASH_MOVE:
+            stage = GENERATE_CAPTURES;
+            // A hash move can come from another position with the same key, so it is checked before it is played
+            if (!hashMove.isNull() && board.isLegal(hashMove)) {
+                return hashMove;
+            }
+            hashMove = Move();
+            // fall through
+
+        case GENERATE_CAPTURES:
+            board.generateCaptures(moves);
+            for (int i = 0; i < moves.size(); i++) {
+                scores[i] = captureScore(moves[i]);
+            }
+            current = 0;
+            stage = CAPTURES;
+            // fall through
+
+        case CAPTURES:
+            while (current < moves.size()) {
+                Move move = pickBest();
+                if (move == hashMove) {
+                    continue;
+                }
+                if (!board.seeGE(move, 0)) {
+                    badCaptures.push_back(move);
+                    continue;
+                }
+                return move;
+            }
+            if (capturesOnly) {
+                stage = DONE;
+                return Move();
+            }
+            stage = REFUTATIONS;
+            current = 0;
+            // fall through
+
+        case REFUTATIONS:
+            while (current < 3) {
+                int i = current++;
+                if (isValidRefutation(i)) {
+                    return refutations[i];
+                }
+                refutations[i] = Move();
+            }
+            stage = GENERATE_QUIETS;
+            // fall through
+
+        case GENERATE_QUIETS:
+            board.generateQuiets(moves);
+            for (int i = 0; i < moves.size(); i++) {
+                scores[i] = history ? history->score(board.getPieceAt(moves[i].from()), moves[i]) : 0;
+            }
+            current = 0;
+            stage = QUIETS;
+            // fall through
+
+        case QUIETS:
+            while (current < moves.size()) {
+                Move move = history ? pickBest() : moves[current++];
+                if (!alreadyReturned(move)) {
+                    return move;
+                }
+            }
+            stage = BAD_CAPTURES;
+            current = 0;
+            // fall through
+
+        case BAD_CAPTURES:
+            if (current < badCaptures.size()) {
+                return badCaptures[current++];
+            }
+            stage = DONE;
+            // fall through
+
+        case DONE:
+        default:
+            return Move();
+    }
+}
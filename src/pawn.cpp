@@ -1,6 +0,0 @@
-#include "pawn.h"
-
-Pawn::Pawn(std::string id, std::tuple<int, int> position) : BasePiece(id, position) {}
-
-Pawn::~Pawn() {}
-
@@ -0,0 +1,129 @@
+#include "psqt.h"
+
+int PsqMidgame[12][64];
+int PsqEndgame[12][64];
+
+namespace {
+
+    // Endgame material values in centipawns, indexed by PieceType. The middlegame values are PieceValue
+    const int EndgameValue[6] = { 94, 281, 297, 512, 936, 0 };
+
+    /*
+    Positional bonuses for white pieces, indexed by square: a8 first, h1 last, so they read like a board
+    from white's side.
+    */
+    const int PawnMidgame[64] = {
+          0,   0,   0,   0,   0,   0,   0,   0,
+         50,  50,  50,  50,  50,  50,  50,  50,
+         10,  10,  20,  30,  30,  20,  10,  10,
+          5,   5,  10,  25,  25,  10,   5,   5,
+          0,   0,   0,  20,  20,   0,   0,   0,
+          5,  -5, -10,   0,   0, -10,  -5,   5,
+          5,  10,  10, -20, -20,  10,  10,   5,
+          0,   0,   0,   0,   0,   0,   0,   0
+    };
+
+    // In the endgame a pawn is worth more the closer it is to promoting
+    const int PawnEndgame[64] = {
+          0,   0,   0,   0,   0,   0,   0,   0,
+         80,  80,  80,  80,  80,  80,  80,  80,
+         50,  50,  50,  50,  50,  50,  50,  50,
+         30,  30,  30,  30,  30,  30,  30,  30,
+         15,  15,  15,  15,  15,  15,  15,  15,
+          5,   5,   5,   5,   5,   5,   5,   5,
+          0,   0,   0,   0,   0,   0,   0,   0,
+          0,   0,   0,   0,   0,   0,   0,   0
+    };
+
+    const int Knight[64] = {
+        -50, -40, -30, -30, -30, -30, -40, -50,
+        -40, -20,   0,   0,   0,   0, -20, -40,
+        -30,   0,  10,  15,  15,  10,   0, -30,
+        -30,   5,  15,  20,  20,  15,   5, -30,
+        -30,   0,  15,  20,  20,  15,   0, -30,
+        -30,   5,  10,  15,  15,  10,   5, -30,
+        -40, -20,   0,   5,   5,   0, -20, -40,
+        -50, -40, -30, -30, -30, -30, -40, -50
+    };
+
+    const int Bishop[64] = {
+        -20, -10, -10, -10, -10, -10, -10, -20,
+        -10,   0,   0,   0,   0,   0,   0, -10,
+        -10,   0,   5,  10,  10,   5,   0, -10,
+        -10,   5,   5,  10,  10,   5,   5, -10,
+        -10,   0,  10,  10,  10,  10,   0, -10,
+        -10,  10,  10,  10,  10,  10,  10, -10,
+        -10,   5,   0,   0,   0,   0,   5, -10,
+        -20, -10, -10, -10, -10, -10, -10, -20
+    };
+
+    const int Rook[64] = {
+          0,   0,   0,   0,   0,   0,   0,   0,
+          5,  10,  10,  10,  10,  10,  10,   5,
+         -5,   0,   0,   0,   0,   0,   0,  -5,
+         -5,   0,   0,   0,   0,   0,   0,  -5,
+         -5,   0,   0,   0,   0,   0,   0,  -5,
+         -5,   0,   0,   0,   0,   0,   0,  -5,
+         -5,   0,   0,   0,   0,   0,   0,  -5,
+          0,   0,   0,   5,   5,   0,   0,   0
+    };
+
+    const int Queen[64] = {
+        -20, -10, -10,  -5,  -5, -10, -10, -20,
+        -10,   0,   0,   0,   0,   0,   0, -10,
+        -10,   0,   5,   5,   5,   5,   0, -10,
+         -5,   0,   5,   5,   5,   5,   0,  -5,
+          0,   0,   5,   5,   5,   5,   0,  -5,
+        -10,   5,   5,   5,   5,   5,   0, -10,
+        -10,   0,   5,   0,   0,   0,   0, -10,
+        -20, -10, -10,  -5,  -5, -10, -10, -20
+    };
+
+    // In the middlegame the king shelters behind its pawns
+    const int KingMidgame[64] = {
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -30, -40, -40, -50, -50, -40, -40, -30,
+        -20, -30, -30, -40, -40, -30, -30, -20,
+        -10, -20, -20, -20, -20, -20, -20, -10,
+         20,  20,   0,   0,   0,   0,  20,  20,
+         20,  30,  10,   0,   0,  10,  30,  20
+    };
+
+    // In the endgame the king joins the fight from the centre
+    const int KingEndgame[64] = {
+        -50, -40, -30, -20, -20, -30, -40, -50,
+        -30, -20, -10,   0,   0, -10, -20, -30,
+        -30, -10,  20,  30,  30,  20, -10, -30,
+        -30, -10,  30,  40,  40,  30, -10, -30,
+        -30, -10,  30,  40,  40,  30, -10, -30,
+        -30, -10,  20,  30,  30,  20, -10, -30,
+        -30, -30,   0,   0,   0,   0, -30, -30,
+        -50, -30, -30, -30, -30, -30, -30, -50
+    };
+
+    const int* const MidgameTables[6] = { PawnMidgame, Knight, Bishop, Rook, Queen, KingMidgame };
+    const int* const EndgameTables[6] = { PawnEndgame, Knight, Bishop, Rook, Queen, KingEndgame };
+
+    bool initTables() {
+        for (int pt = PAWN; pt <= KING; pt++) {
+            for (int sq = 0; sq < 64; sq++) {
+                Piece white = makePiece(WHITE, PieceType(pt));
+                Piece black = makePiece(BLACK, PieceType(pt));
+                PsqMidgame[white][sq] = PieceValue[pt] + MidgameTables[pt][sq];
+                PsqEndgame[white][sq] = EndgameValue[pt] + EndgameTables[pt][sq];
+
+                // Flipping the rank mirrors the board top to bottom
+                PsqMidgame[black][sq] = -(PieceValue[pt] + MidgameTables[pt][sq ^ 56]);
+                PsqEndgame[black][sq] = -(EndgameValue[pt] + EndgameTables[pt][sq ^ 56]);
+            }
+        }
+        return true;
+    }
+}
+
+void initPSQT() {
+    static bool initialized = initTables();
+    (void)initialized;
+}
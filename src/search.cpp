@@ -0,0 +1,448 @@
+#include "search.h"
+#include "evaluate.h"
+#include "movepicker.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+
+    // Mate scores are stored relative to the position instead of the root, so they stay correct when
+    // the position is reached again at a different ply
+    int scoreToTT(int score, int ply) {
+        return (score >= VALUE_MATE_IN_MAX_PLY) ? score + ply : (score <= -VALUE_MATE_IN_MAX_PLY) ? score - ply : score;
+    }
+
+    int scoreFromTT(int score, int ply) {
+        return (score >= VALUE_MATE_IN_MAX_PLY) ? score - ply : (score <= -VALUE_MATE_IN_MAX_PLY) ? score + ply : score;
+    }
+
+    // Depth skew of the helper threads: helper i skips the iterations where (depth + SkipPhase[i]) / SkipSize[i]
+    // is odd, so pairs of helpers take turns over blocks of 1, 2, 3 and 4 depths
+    const int SKIP_PATTERNS = 20;
+    const int SkipSize[SKIP_PATTERNS] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+    const int SkipPhase[SKIP_PATTERNS] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+    // Margins of the pruning near the leaves, in centipawns per ply of remaining depth
+    const int ReverseFutilityMargin = 80;
+    const int FutilityMargin = 120;
+    const int RazorMargin = 250;
+
+    // Half width of the first aspiration window, and the first iteration searched with one
+    const int AspirationDelta = 25;
+    const int AspirationDepth = 5;
+
+    // Late move reductions in plies, indexed [depth][move number], both capped at 63
+    int Reductions[64][64];
+
+    bool initTables() {
+        for (int depth = 1; depth < 64; depth++) {
+            for (int moveCount = 1; moveCount < 64; moveCount++) {
+                Reductions[depth][moveCount] = int(0.75 + std::log(double(depth)) * std::log(double(moveCount)) / 2.25);
+            }
+        }
+        return true;
+    }
+
+    void initReductions() {
+        static bool initialized = initTables();
+        (void)initialized;
+    }
+
+    int reduction(int depth, int moveCount) {
+        return Reductions[std::min(depth, 63)][std::min(moveCount, 63)];
+    }
+
+}
+
+
+Search::Search(Board& board) :
+    board(board), ownTable(new TranspositionTable()), tt(*ownTable), nodes(0), stopped(false),
+    stopSignal(nullptr), threadId(0) {
+    initReductions();
+    pvLength[0] = 0;
+}
+
+Search::Search(Board& board, TranspositionTable& tt, std::atomic<bool>* stopSignal, int threadId) :
+    board(board), tt(tt), nodes(0), stopped(false), stopSignal(stopSignal), threadId(threadId) {
+    initReductions();
+    pvLength[0] = 0;
+}
+
+SearchResult Search::run(const SearchLimits& limits) {
+    this->limits = limits;
+    nodes = 0;
+    stats = SearchStats();
+    tableStats = TTStats();
+    stopped = false;
+    timeManager.start(limits, board.getWhiteToPlay());
+    rootBestMove = Move();
+    history.clear();
+    for (int ply = 0; ply < MAX_PLY; ply++) {
+        killers[ply][0] = killers[ply][1] = Move();
+    }
+    if (ownTable) {
+        tt.newSearch();
+    }
+
+    SearchResult result;
+    int stableIterations = 0;
+    int maxDepth = (limits.depth > 0 && limits.depth < MAX_PLY) ? limits.depth : MAX_PLY - 1;
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        if (threadId > 0 && depth > 1) {
+            int i = (threadId - 1) % SKIP_PATTERNS;
+            if (((depth + SkipPhase[i]) / SkipSize[i]) % 2) {
+                continue;
+            }
+        }
+
+        // The score rarely moves far between iterations, and a narrow window cuts more. A score outside the
+        // window is only a bound, so the window widens on that side and the root is searched again
+        int delta = AspirationDelta;
+        int alpha = -VALUE_INFINITE;
+        int beta = VALUE_INFINITE;
+        if (depth >= AspirationDepth && std::abs(result.score) < VALUE_MATE_IN_MAX_PLY) {
+            alpha = std::max(result.score - delta, -VALUE_INFINITE);
+            beta = std::min(result.score + delta, VALUE_INFINITE);
+        }
+        int score;
+        while (true) {
+            score = negamax(depth, 0, alpha, beta);
+            if (stopped) {
+                break;
+            }
+            if (score <= alpha) {
+                stats.aspirationFailLows++;
+                beta = (alpha + beta) / 2;
+                alpha = std::max(score - delta, -VALUE_INFINITE);
+            }
+            else if (score >= beta) {
+                stats.aspirationFailHighs++;
+                beta = std::min(score + delta, VALUE_INFINITE);
+            }
+            else {
+                break;
+            }
+            delta += delta / 2;
+        }
+
+        // An iteration cut short by a limit or the stop signal has not looked at every move, its result is thrown away
+        if (stopped) {
+            break;
+        }
+
+        int scoreDrop = (result.depth > 0) ? result.score - score : 0;
+        result.score = score;
+        result.depth = depth;
+        result.pv.assign(pvTable[0], pvTable[0] + pvLength[0]);
+        result.bestMove = result.pv.empty() ? Move() : result.pv[0];
+        stableIterations = (result.bestMove == rootBestMove) ? stableIterations + 1 : 0;
+        rootBestMove = result.bestMove;
+
+        // No legal moves, or a forced mate: a deeper search finds nothing shorter
+        if (result.bestMove.isNull() || score >= VALUE_MATE_IN_MAX_PLY || score <= -VALUE_MATE_IN_MAX_PLY) {
+            break;
+        }
+
+        if (timeManager.softLimitReached(stableIterations, scoreDrop)) {
+            break;
+        }
+    }
+
+    // If not even the first iteration completed, any legal move is better than none
+    if (result.bestMove.isNull()) {
+        MoveList moves;
+        board.generateMoves(moves);
+        if (!moves.empty()) {
+            result.bestMove = moves[0];
+            result.pv.assign(1, moves[0]);
+        }
+    }
+
+    result.nodes = nodes;
+    result.stats = stats;
+    result.tableStats = tableStats;
+    return result;
+}
+
+void Search::updateQuietStats(int ply, int depth, Move move, const Move* quiets, int quietCount) {
+    if (killers[ply][0] != move) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+
+    Move previous = (ply > 0) ? currentMove[ply - 1] : Move();
+    if (!previous.isNull()) {
+        history.setCounterMove(board.getPieceAt(previous.to()), previous.to(), move);
+    }
+
+    int bonus = History::bonus(depth);
+    history.update(board.getPieceAt(move.from()), move, bonus);
+    for (int i = 0; i < quietCount; i++) {
+        history.update(board.getPieceAt(quiets[i].from()), quiets[i], -bonus);
+    }
+}
+
+bool Search::shouldStop() {
+    // A relaxed load compiles to a plain load, cheap enough for every node, so a stop is seen at once
+    if (stopSignal && stopSignal->load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (limits.nodes && nodes >= limits.nodes) {
+        return true;
+    }
+    if ((nodes & 1023) == 0 && timeManager.hardLimitReached()) {
+        stats.hardLimitNodes = nodes;
+        if (stopSignal) {
+            stopSignal->store(true, std::memory_order_relaxed);
+        }
+        return true;
+    }
+    return false;
+}
+
+void Search::updatePV(int ply, Move move) {
+    pvTable[ply][ply] = move;
+    for (int i = ply + 1; i < pvLength[ply + 1]; i++) {
+        pvTable[ply][i] = pvTable[ply + 1][i];
+    }
+    pvLength[ply] = pvLength[ply + 1];
+}
+
+int Search::negamax(int depth, int ply, int alpha, int beta) {
+    if (depth <= 0) {
+        return quiescence(ply, alpha, beta);
+    }
+
+    pvLength[ply] = ply;
+
+    if (shouldStop()) {
+        stopped = true;
+        return 0;
+    }
+    nodes++;
+
+    // A repeated position or fifty moves without a capture or pawn move is a draw. The root is always searched,
+    // so there is a move to play
+    if (ply > 0 && (board.getHalfMove() >= 100 || board.isRepetition())) {
+        return VALUE_DRAW;
+    }
+
+    if (ply >= MAX_PLY - 1) {
+        return evaluate(board);
+    }
+
+    bool pvNode = beta - alpha > 1;
+
+    // A stored search at least as deep decides this node if its bound does. Not in PV nodes, which have to
+    // search to fill in the principal variation; the root is one of them, so it always has a move
+    Key key = board.getKey();
+    TTData ttData;
+    bool ttHit = tt.probe(key, ttData, &tableStats);
+    if (ttHit && !pvNode && ttData.depth >= depth) {
+        int ttScore = scoreFromTT(ttData.score, ply);
+        if (ttData.bound == BOUND_EXACT
+            || (ttData.bound == BOUND_LOWER && ttScore >= beta)
+            || (ttData.bound == BOUND_UPPER && ttScore <= alpha)) {
+            return ttScore;
+        }
+    }
+    Move ttMove = ttHit ? ttData.move : Move();
+
+    // Selective pruning is only safe in null window nodes, whose score is only compared to beta, and never in
+    // check, where every evasion has to be searched
+    bool inCheck = board.inCheck();
+    int staticEval = inCheck ? -VALUE_INFINITE : evaluate(board);
+    bool pruning = !pvNode && !inCheck;
+
+    // Reverse futility: a static evaluation this far above beta is not expected to fall below it in a few plies
+    if (pruning && options.reverseFutility && depth <= 6 && std::abs(beta) < VALUE_MATE_IN_MAX_PLY
+        && staticEval - ReverseFutilityMargin * depth >= beta) {
+        return staticEval;
+    }
+
+    // Razoring: far below alpha near the leaves, only a capture can help, and the quiescence search decides
+    if (pruning && options.razoring && depth <= 3 && staticEval + RazorMargin * depth < alpha) {
+        int score = quiescence(ply, alpha - 1, alpha);
+        if (stopped) {
+            return 0;
+        }
+        if (score < alpha) {
+            return score;
+        }
+    }
+
+    // Null move: if passing still beats beta, a real move would too. Not after another null move, and not with
+    // pawns and king only, where passing may be the best move (zugzwang)
+    Color us = board.getWhiteToPlay() ? WHITE : BLACK;
+    bool hasPieces = board.getBitboard(us, KNIGHT) | board.getBitboard(us, BISHOP) | board.getBitboard(us, ROOK)
+        | board.getBitboard(us, QUEEN);
+    if (pruning && options.nullMove && ply > 0 && depth >= 3 && staticEval >= beta && hasPieces
+        && !currentMove[ply - 1].isNull()) {
+        int r = 3 + depth / 4;
+        currentMove[ply] = Move();
+        board.makeNullMove();
+        int score = -negamax(depth - 1 - r, ply + 1, -beta, -beta + 1);
+        board.unmakeNullMove();
+        if (stopped) {
+            return 0;
+        }
+        // A mate found after passing is not proven, as the pass is not a legal move
+        if (score >= beta) {
+            return (score >= VALUE_MATE_IN_MAX_PLY) ? beta : score;
+        }
+    }
+
+    Move previous = (ply > 0) ? currentMove[ply - 1] : Move();
+    Move counterMove = previous.isNull() ? Move() : history.getCounterMove(board.getPieceAt(previous.to()), previous.to());
+    MovePicker picker(board, (ply == 0 && !rootBestMove.isNull()) ? rootBestMove : ttMove,
+                      killers[ply][0], killers[ply][1], counterMove, &history);
+    int originalAlpha = alpha;
+    int bestScore = -VALUE_INFINITE;
+    Move bestMove;
+    int moveCount = 0;
+
+    // Quiet moves searched without a cutoff, punished in the history if a later quiet move cuts off
+    Move quiets[64];
+    int quietCount = 0;
+
+    for (Move move = picker.next(); !move.isNull(); move = picker.next()) {
+        moveCount++;
+        bool quiet = !move.isCapture() && !move.isPromotion();
+
+        currentMove[ply] = move;
+        board.makeMove(move);
+        bool givesCheck = board.inCheck();
+
+        // Futility: a quiet move near the leaves that does not give check is not expected to gain more than the
+        // margin over the static evaluation. Not while being mated, when any move may be the only defence
+        if (pruning && options.futility && quiet && !givesCheck && moveCount > 1 && depth <= 3
+            && alpha > -VALUE_MATE_IN_MAX_PLY && staticEval + FutilityMargin * depth <= alpha) {
+            board.unmakeMove(move);
+            bestScore = std::max(bestScore, staticEval + FutilityMargin * depth);
+            continue;
+        }
+
+        // Principal variation search: the first move is expected to be best and gets the full window. The others
+        // only have to be shown no better than alpha, with a null window. Late move reductions: quiet moves ordered
+        // late rarely raise alpha, so their null window search is also shallower. A move that does raise alpha is
+        // searched again at full depth, then with the full window
+        int score;
+        if (moveCount == 1) {
+            score = -negamax(depth - 1, ply + 1, -beta, -alpha);
+        }
+        else {
+            int r = 0;
+            if (options.lateMoveReductions && depth >= 3 && moveCount > 1 + pvNode && quiet && !inCheck && !givesCheck) {
+                r = std::max(0, std::min(reduction(depth, moveCount) - pvNode, depth - 2));
+            }
+            score = -negamax(depth - 1 - r, ply + 1, -alpha - 1, -alpha);
+            if (r > 0 && score > alpha && !stopped) {
+                stats.lmrResearches++;
+                score = -negamax(depth - 1, ply + 1, -alpha - 1, -alpha);
+            }
+            if (score > alpha && score < beta && !stopped) {
+                stats.pvsResearches++;
+                score = -negamax(depth - 1, ply + 1, -beta, -alpha);
+            }
+        }
+        board.unmakeMove(move);
+
+        if (stopped) {
+            return 0;
+        }
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+            if (score > alpha) {
+                alpha = score;
+                updatePV(ply, move);
+                if (alpha >= beta) {
+                    if (quiet) {
+                        updateQuietStats(ply, depth, move, quiets, quietCount);
+                    }
+                    break;
+                }
+            }
+        }
+
+        if (quiet && quietCount < 64) {
+            quiets[quietCount++] = move;
+        }
+    }
+
+    // No legal moves: checkmate, scored by the distance to the root so faster mates are preferred, or stalemate
+    if (moveCount == 0) {
+        return inCheck ? -VALUE_MATE + ply : VALUE_DRAW;
+    }
+
+    // A fail low has no best move worth keeping, every move was refuted
+    Bound bound = (bestScore >= beta) ? BOUND_LOWER : (alpha > originalAlpha) ? BOUND_EXACT : BOUND_UPPER;
+    tt.store(key, (bound == BOUND_UPPER) ? Move() : bestMove, scoreToTT(bestScore, ply), depth, bound, &tableStats);
+
+    return bestScore;
+}
+
+int Search::quiescence(int ply, int alpha, int beta) {
+    pvLength[ply] = ply;
+
+    if (shouldStop()) {
+        stopped = true;
+        return 0;
+    }
+    nodes++;
+
+    if (ply >= MAX_PLY - 1) {
+        return evaluate(board);
+    }
+
+    // In check there is no standing pat: every evasion is searched, and having none is mate. Otherwise the side
+    // to move can decline every capture, so the static evaluation is a lower bound on the score
+    bool inCheck = board.inCheck();
+    int bestScore = -VALUE_INFINITE;
+    if (!inCheck) {
+        bestScore = evaluate(board);
+        if (bestScore >= beta) {
+            return bestScore;
+        }
+        if (bestScore > alpha) {
+            alpha = bestScore;
+        }
+    }
+
+    MovePicker picker(board, !inCheck);
+    int moveCount = 0;
+
+    // Out of check the picker drops the captures that lose material on the exchange: they cannot raise a score
+    // the stand pat already holds
+    for (Move move = picker.next(); !move.isNull(); move = picker.next()) {
+        moveCount++;
+
+        board.makeMove(move);
+        int score = -quiescence(ply + 1, -beta, -alpha);
+        board.unmakeMove(move);
+
+        if (stopped) {
+            return 0;
+        }
+
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                updatePV(ply, move);
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+
+    if (inCheck && moveCount == 0) {
+        return -VALUE_MATE + ply;
+    }
+
+    return bestScore;
+}
@@ -0,0 +1,143 @@
+#include "threadPool.h"
+
+#include <algorithm>
+#include <utility>
+
+
+namespace {
+
+    // Pool and worker index of the calling thread, set on the worker threads
+    thread_local const ThreadPool* currentPool = nullptr;
+    thread_local int currentWorker = -1;
+
+}
+
+
+ThreadPool::ThreadPool(int threads, size_t capacity) :
+    capacity((capacity > 0) ? capacity : 1), queued(0), unfinished(0), nextWorker(0), stopping(false) {
+    if (threads <= 0) {
+        threads = std::max(1, int(std::thread::hardware_concurrency()));
+    }
+    for (int i = 0; i < threads; i++) {
+        workers.push_back(std::unique_ptr<Worker>(new Worker()));
+    }
+    for (int i = 0; i < threads; i++) {
+        this->threads.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+int ThreadPool::workerIndex() const {
+    return (currentPool == this) ? currentWorker : -1;
+}
+
+void ThreadPool::submit(std::function<void()> task, int affinity) {
+    int self = workerIndex();
+    {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        if (self < 0) {
+            notFull.wait(lock, [this] { return queued < capacity; });
+        }
+
+        int target = (affinity >= 0) ? affinity % size() : (self >= 0) ? self : int(nextWorker++ % workers.size());
+        {
+            std::lock_guard<std::mutex> workerLock(workers[target]->mutex);
+            workers[target]->tasks.push_back(std::move(task));
+        }
+        queued++;
+        unfinished++;
+    }
+    workAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this] { return unfinished == 0; });
+    if (error) {
+        std::exception_ptr thrown = error;
+        error = nullptr;
+        std::rethrow_exception(thrown);
+    }
+}
+
+bool ThreadPool::popTask(int index, std::function<void()>& task) {
+    // Newest task of our own deque first: it was likely submitted by the task this worker just ran,
+    // and its data is still in this core's cache
+    bool found = false;
+    {
+        Worker& own = *workers[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            found = true;
+        }
+    }
+
+    // Otherwise steal the oldest task of another worker, looking at the workers after us first
+    for (size_t i = 1; !found && i < workers.size(); i++) {
+        Worker& victim = *workers[(index + i) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            found = true;
+        }
+    }
+
+    if (found) {
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            queued--;
+        }
+        notFull.notify_one();
+    }
+    return found;
+}
+
+void ThreadPool::workerLoop(int index) {
+    currentPool = this;
+    currentWorker = index;
+
+    while (true) {
+        std::function<void()> task;
+        if (popTask(index, task)) {
+            try {
+                task();
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+
+            bool done;
+            {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                done = (--unfinished == 0);
+            }
+            if (done) {
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        // Nothing to run or steal: sleep until a task is queued. Workers only stop once every task is taken
+        std::unique_lock<std::mutex> lock(stateMutex);
+        workAvailable.wait(lock, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0) {
+            return;
+        }
+    }
+}
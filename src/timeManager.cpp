@@ -0,0 +1,64 @@
+#include "timeManager.h"
+#include "search.h"
+
+#include <algorithm>
+
+
+namespace {
+
+    // Time kept back from every move for the engine's own overhead and the caller's, in milliseconds
+    const int64_t MoveOverhead = 10;
+
+    // Moves the remaining time is assumed to last for when the caller does not say
+    const int DefaultMovesToGo = 40;
+
+}
+
+
+TimeManager::TimeManager() : optimum(0), maximum(0), limited(false), fixedTime(false) {
+    startTime = std::chrono::steady_clock::now();
+}
+
+void TimeManager::start(const SearchLimits& limits, bool whiteToPlay) {
+    startTime = std::chrono::steady_clock::now();
+    int64_t time = whiteToPlay ? limits.wtime : limits.btime;
+    int64_t increment = whiteToPlay ? limits.winc : limits.binc;
+    fixedTime = limits.movetime > 0;
+
+    if (limits.movetime > 0) {
+        limited = true;
+        optimum = maximum = std::max<int64_t>(1, limits.movetime - MoveOverhead);
+    }
+    else if (time > 0) {
+        // Share the time left and the increments still to come between the moves to go. A single move may
+        // take up to five shares, but never more than most of the time actually on the clock
+        limited = true;
+        int movesToGo = (limits.movestogo > 0) ? std::min(limits.movestogo, 50) : DefaultMovesToGo;
+        int64_t available = std::max<int64_t>(1, time + increment * (movesToGo - 1) - MoveOverhead * movesToGo);
+        int64_t cap = std::max<int64_t>(1, std::min(time - MoveOverhead, time * 4 / 5));
+        optimum = std::min(available / movesToGo, cap);
+        maximum = std::min(optimum * 5, cap);
+        optimum = std::max<int64_t>(1, optimum);
+    }
+    else {
+        limited = false;
+        optimum = maximum = 0;
+    }
+}
+
+int64_t TimeManager::elapsed() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+bool TimeManager::softLimitReached(int stableIterations, int scoreDrop) const {
+    if (!limited || fixedTime) {
+        return false;
+    }
+
+    // A best move that just changed needs confirming and earns up to 30% more time; one that has held for several
+    // iterations is settled and gets as little as half. A falling score gets up to twice the time to find a fix
+    double stability = std::max(0.5, 1.3 - 0.1 * stableIterations);
+    double swing = 1.0 + std::min(std::max(scoreDrop, 0), 100) / 100.0;
+    int64_t soft = std::min(int64_t(optimum * stability * swing), maximum);
+    return elapsed() >= soft;
+}
@@ -0,0 +1,161 @@
+#include "transpositionTable.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+    uint64_t pack(Move move, int score, int depth, Bound bound, uint8_t generation) {
+        return uint64_t(move.raw())
+             | (uint64_t(uint16_t(int16_t(score))) << 16)
+             | (uint64_t(uint8_t(int8_t(depth))) << 32)
+             | (uint64_t(bound) << 40)
+             | (uint64_t(generation) << 42);
+    }
+
+    Move moveOf(uint64_t data) { return Move(int(data & 0x3F), int((data >> 6) & 0x3F), int((data >> 12) & 0xF)); }
+    int scoreOf(uint64_t data) { return int16_t(uint16_t(data >> 16)); }
+    int depthOf(uint64_t data) { return int8_t(uint8_t(data >> 32)); }
+    Bound boundOf(uint64_t data) { return Bound((data >> 40) & 3); }
+    uint8_t generationOf(uint64_t data) { return uint8_t((data >> 42) & 63); }
+
+}
+
+
+TranspositionTable::TranspositionTable(size_t megabytes) :
+    buckets(nullptr), bucketCount(0), generation(0) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+    // Largest power of two number of buckets that fits
+    size_t wanted = megabytes * 1024 * 1024 / sizeof(TTBucket);
+    bucketCount = 1;
+    while (bucketCount * 2 <= wanted) {
+        bucketCount *= 2;
+    }
+
+    // new[] does not honor the 64 byte alignment of a bucket before C++17, so the buckets are placed on
+    // the first cache line boundary of a slightly larger block
+    memory.reset(new char[bucketCount * sizeof(TTBucket) + alignof(TTBucket)]);
+    uintptr_t address = reinterpret_cast<uintptr_t>(memory.get());
+    buckets = reinterpret_cast<TTBucket*>((address + alignof(TTBucket) - 1) & ~uintptr_t(alignof(TTBucket) - 1));
+
+    clear();
+}
+
+void TranspositionTable::clear(int threads) {
+    // Each thread zeroes a contiguous slice, so large tables clear at memory bandwidth
+    size_t slice = (bucketCount + threads - 1) / threads;
+    auto clearSlice = [this, slice](int i) {
+        size_t start = std::min(bucketCount, i * slice);
+        size_t end = std::min(bucketCount, start + slice);
+        std::memset(static_cast<void*>(buckets + start), 0, (end - start) * sizeof(TTBucket));
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; i++) {
+        workers.push_back(std::thread(clearSlice, i));
+    }
+    clearSlice(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    generation = 0;
+}
+
+bool TranspositionTable::probe(Key key, TTData& data, TTStats* stats) {
+    if (stats) {
+        stats->probes++;
+    }
+
+    TTBucket& bucket = bucketOf(key);
+    for (int i = 0; i < TT_BUCKET_SIZE; i++) {
+        uint64_t entryData = bucket.entries[i].data.load(std::memory_order_relaxed);
+        uint64_t entryKey = bucket.entries[i].keyXorData.load(std::memory_order_relaxed) ^ entryData;
+        if (entryKey == key && entryData != 0) {
+            data.move = moveOf(entryData);
+            data.score = scoreOf(entryData);
+            data.depth = depthOf(entryData);
+            data.bound = boundOf(entryData);
+            if (stats) {
+                stats->hits++;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(Key key, Move move, int score, int depth, Bound bound, TTStats* stats) {
+    TTBucket& bucket = bucketOf(key);
+
+    // Replace the entry of the same position if there is one, otherwise the least valuable entry: the
+    // shallowest, with every search since the entry was stored counting as 8 plies of depth
+    TTEntry* replace = nullptr;
+    uint64_t replaceData = 0;
+    int lowestWorth = 0;
+    for (int i = 0; i < TT_BUCKET_SIZE; i++) {
+        TTEntry& entry = bucket.entries[i];
+        uint64_t entryData = entry.data.load(std::memory_order_relaxed);
+        uint64_t entryKey = entry.keyXorData.load(std::memory_order_relaxed) ^ entryData;
+        if (entryKey == key || entryData == 0) {
+            replace = &entry;
+            replaceData = entryData;
+            break;
+        }
+        int age = (generation - generationOf(entryData)) & 63;
+        int worth = depthOf(entryData) - 8 * age;
+        if (!replace || worth < lowestWorth) {
+            replace = &entry;
+            replaceData = entryData;
+            lowestWorth = worth;
+        }
+    }
+
+    bool samePosition = replaceData != 0 && (replace->keyXorData.load(std::memory_order_relaxed) ^ replaceData) == key;
+    if (samePosition) {
+        // A much deeper search of the position is worth more than a shallower bound. An exact score always
+        // replaces it, and the stored move is kept if this search found none
+        if (depth + 4 < depthOf(replaceData) && bound != BOUND_EXACT) {
+            return;
+        }
+        if (move.isNull()) {
+            move = moveOf(replaceData);
+        }
+    }
+    else if (stats && replaceData != 0 && generationOf(replaceData) == generation) {
+        stats->collisions++;
+    }
+
+    uint64_t data = pack(move, score, depth, bound, generation);
+    replace->keyXorData.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::prefetch(Key key) const {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(&bucketOf(key));
+#else
+    (void)key;
+#endif
+}
+
+int TranspositionTable::hashfull() const {
+    // Sample the first thousand buckets
+    size_t sample = std::min(bucketCount, size_t(1000));
+    int used = 0;
+    for (size_t b = 0; b < sample; b++) {
+        for (int i = 0; i < TT_BUCKET_SIZE; i++) {
+            uint64_t entryData = buckets[b].entries[i].data.load(std::memory_order_relaxed);
+            if (entryData != 0 && generationOf(entryData) == generation) {
+                used++;
+            }
+        }
+    }
+    return int(used * 1000 / (sample * TT_BUCKET_SIZE));
+}
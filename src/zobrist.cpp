@@ -0,0 +1,62 @@
+#include "zobrist.h"
+
+Key ZobristPieces[12][64];
+Key ZobristCastling[16];
+Key ZobristEnPassant[8];
+Key ZobristSide;
+
+namespace {
+
+    /**
+     * @brief xorshift64* pseudo random number generator. Good enough for hash keys and, 
+     * unlike std::rand, gives the same 64 bit numbers on every platform.
+     */
+    class PRNG {
+        private:
+            uint64_t s;
+
+        public:
+            PRNG(uint64_t seed) : s(seed) {}
+
+            uint64_t next() {
+                s ^= s >> 12;
+                s ^= s << 25;
+                s ^= s >> 27;
+                return s * 2685821657736338717ULL;
+            }
+    };
+
+    bool initKeys() {
+        PRNG rng(1070372);
+
+        for (int p = 0; p < 12; p++) {
+            for (int sq = 0; sq < 64; sq++) {
+                ZobristPieces[p][sq] = rng.next();
+            }
+        }
+
+        // Each castling right gets a random key, and every combination of rights is the XOR of its rights
+        Key rightKeys[4];
+        for (int i = 0; i < 4; i++) {
+            rightKeys[i] = rng.next();
+        }
+        for (int rights = 0; rights < 16; rights++) {
+            ZobristCastling[rights] = 0;
+            for (int i = 0; i < 4; i++) {
+                if (rights & (1 << i))
+                    ZobristCastling[rights] ^= rightKeys[i];
+            }
+        }
+
+        for (int file = 0; file < 8; file++) {
+            ZobristEnPassant[file] = rng.next();
+        }
+        ZobristSide = rng.next();
+        return true;
+    }
+}
+
+void initZobrist() {
+    static bool initialized = initKeys();
+    (void)initialized;
+}
@@ -1,10 +1,21 @@
 #include <gtest/gtest.h>
+#include <chrono>
 #include <iostream>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
 #include "square.h"
-#include "basepiece.h"
 #include "board.h"
 #include "move.h"
 #include "castlingRights.h"
+#include "evaluate.h"
+#include "history.h"
+#include "movepicker.h"
+#include "search.h"
+#include "transpositionTable.h"
+#include "lazySMP.h"
+#include "threadPool.h"
+#include "timeManager.h"
 
 
 TEST(SquareTest, getLocation) {
@@ -15,66 +26,123 @@ TEST(SquareTest, getLocation) {
     EXPECT_EQ(std::get<1>(loc), 2);
 }
 
-TEST(SquareTest, getBasePieceEmpty) {
+TEST(SquareTest, getPieceEmpty) {
     Square s(0, 0);
-    EXPECT_EQ(s.getPiece(), nullptr);
+    EXPECT_EQ(s.getPiece(), NO_PIECE);
 }
 
-TEST(SquareTest, getBasePiece) {
-    
-    BasePiece bp("wp");
-    Square s(1, 5, &bp);
+TEST(SquareTest, getPiece) {
+    Square s(1, 5, W_PAWN);
 
-    EXPECT_EQ(s.getPiece(), &bp);
+    EXPECT_EQ(s.getPiece(), W_PAWN);
+    s.setPiece(B_QUEEN);
+    EXPECT_EQ(s.getPiece(), B_QUEEN);
 }
 
 TEST(SquareTest, testEquality) {
-    BasePiece bp("wQ");
-    Square s(0, 0, &bp);
+    Square s(0, 0, W_QUEEN);
     Square s2 = s;
     Square s3(s);
     EXPECT_TRUE(s2 == s);
     EXPECT_TRUE(s3 == s);
+    EXPECT_TRUE(s != Square(0, 0, B_QUEEN));
 }
 
-TEST(BasePieceTests, init) {
-    BasePiece bp("wp");
-    EXPECT_EQ(bp.getID(), "wp");
+TEST(PieceTests, init) {
+    EXPECT_EQ(pieceToID(W_PAWN), "wp");
+    EXPECT_EQ(pieceToID(B_KING), "bK");
+    EXPECT_EQ(makePiece(BLACK, KNIGHT), B_KNIGHT);
+    EXPECT_EQ(colorOf(B_KNIGHT), BLACK);
+    EXPECT_EQ(typeOf(W_ROOK), ROOK);
+    EXPECT_EQ(sizeof(Piece), 1);
 }
 
-TEST(MoveTests, testID) {
+TEST(MoveTests, testEncoding) {
     std::tuple<int, int> start = std::make_tuple(1, 1);
-    std::tuple<int, int> end = std::make_tuple(3, 3);
-    Move move(start, end, nullptr, nullptr);
-    EXPECT_EQ(move.getMoveID(), 1133);
+    std::tuple<int, int> end = std::make_tuple(3, 1);
+    Move move(start, end, DOUBLE_PAWN_PUSH);
+
+    EXPECT_EQ(sizeof(Move), 2);
+    EXPECT_EQ(move.from(), squareIndex(1, 1));
+    EXPECT_EQ(move.to(), squareIndex(3, 1));
+    EXPECT_TRUE(move.getStart() == start);
+    EXPECT_TRUE(move.getEnd() == end);
+    EXPECT_TRUE(move.isDoublePawnPush());
+    EXPECT_FALSE(move.isCapture());
+    EXPECT_TRUE(move == Move(squareIndex(1, 1), squareIndex(3, 1), DOUBLE_PAWN_PUSH));
+    EXPECT_TRUE(move != Move(squareIndex(1, 1), squareIndex(3, 1)));
+
+    Move promotion(squareIndex(1, 4), squareIndex(0, 3), QUEEN_PROMOTION_CAPTURE);
+    EXPECT_TRUE(promotion.isPromotion());
+    EXPECT_TRUE(promotion.isCapture());
+    EXPECT_EQ(promotion.promotionType(), QUEEN);
+    EXPECT_EQ(moveToString(promotion), "e7d8q");
+
+    EXPECT_TRUE(Move(squareIndex(7, 4), squareIndex(7, 6), KING_CASTLE).isCastle());
+    EXPECT_TRUE(Move(squareIndex(3, 4), squareIndex(2, 3), EN_PASSANT).isEnPassant());
+    EXPECT_TRUE(Move(squareIndex(3, 4), squareIndex(2, 3), EN_PASSANT).isCapture());
+    EXPECT_TRUE(Move().isNull());
 }
 
-TEST(MoveTests, testGetRankFile) {
-    std::tuple<int, int> start = std::make_tuple(1, 1);
-    std::tuple<int, int> end = std::make_tuple(3, 3);
-    Move move(start, end, nullptr, nullptr);
+TEST(MoveTests, testMoveList) {
+    MoveList moves;
+    EXPECT_TRUE(moves.empty());
+
+    moves.push_back(Move(squareIndex(6, 4), squareIndex(4, 4), DOUBLE_PAWN_PUSH));
+    moves.push_back(Move(squareIndex(7, 6), squareIndex(5, 5)));
+    moves.push_back(Move(squareIndex(6, 3), squareIndex(5, 4), CAPTURE));
+    EXPECT_EQ(moves.size(), 3);
+    EXPECT_TRUE(moves.contains(Move(squareIndex(7, 6), squareIndex(5, 5))));
+    EXPECT_FALSE(moves.contains(Move(squareIndex(7, 6), squareIndex(5, 7))));
+
+    // Captures first
+    moves.sort([](Move a, Move b) { return a.isCapture() && !b.isCapture(); });
+    EXPECT_TRUE(moves[0].isCapture());
+
+    int count = 0;
+    for (Move move : moves) {
+        EXPECT_FALSE(move.isNull());
+        count++;
+    }
+    EXPECT_EQ(count, 3);
+
+    moves.erase(0);
+    EXPECT_EQ(moves.size(), 2);
+    EXPECT_FALSE(moves.contains(Move(squareIndex(6, 3), squareIndex(5, 4), CAPTURE)));
+
+    // The board generators clear the list before filling it
+    Board b("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    b.generateMoves(moves);
+    EXPECT_EQ(moves.size(), 20);
+}
 
-    EXPECT_EQ(move.getRankFile(3, 3), "d5");
-    EXPECT_EQ(move.getRankFile(0, 0), "a8");
-    EXPECT_EQ(move.getRankFile(2, 6), "g6");
+TEST(MoveTests, testGetRankFile) {
+    EXPECT_EQ(squareName(3, 3), "d5");
+    EXPECT_EQ(squareName(0, 0), "a8");
+    EXPECT_EQ(squareName(2, 6), "g6");
+    EXPECT_EQ(squareFromName("e3"), squareIndex(5, 4));
+    EXPECT_EQ(squareFromName("-"), -1);
 }
 
 TEST(MoveTests, testPieceMoved) {
     Board board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
     std::tuple<int, int> start = std::make_tuple(1, 1);
     std::tuple<int, int> end = std::make_tuple(3, 1);
-    Move move(start, end, board.getSquare(start).getPiece(), nullptr);
+    Move move(start, end, DOUBLE_PAWN_PUSH);
 
-    EXPECT_EQ(move.pieceMoved->getID(), "bp");  
+    EXPECT_EQ(board.getPieceAt(move.from()), B_PAWN);
+    EXPECT_EQ(pieceToID(board.getSquare(move.getStart()).getPiece()), "bp");  
 
     start = std::make_tuple(7, 4);
     end = std::make_tuple(0, 0);
-    Move m(start, end, board.getSquare(start).getPiece(), board.getSquare(end).getPiece());
+    Move m(start, end, CAPTURE);
 
-    EXPECT_EQ(m.pieceMoved->getID(), "wK");
+    EXPECT_EQ(pieceToID(board.getSquare(m.getStart()).getPiece()), "wK");
     start = std::make_tuple(6, 0);
     end = std::make_tuple(4, 0);
-    Move mv(start, end, board.getSquare(start).getPiece(), board.getSquare(end).getPiece());
+    Move mv(start, end, DOUBLE_PAWN_PUSH);
+    EXPECT_EQ(moveToAlgebraic(board, mv), "a4");
+    EXPECT_EQ(moveToAlgebraic(board, Move(squareIndex(7, 6), squareIndex(5, 5))), "Nf3");
     std::cout << mv << std::endl;
 }
 
@@ -99,11 +167,11 @@ TEST(BoardTests, testWhiteToPlay) {
 
 TEST(BoardTests, testPieceLocations) {
     Board b("r2qkb1r/pp1nnpp1/2p1p2p/3pPb2/3P4/5N2/PPPNBPPP/R1BQ1RK1 w kq - 0 8");
-    EXPECT_TRUE(b[4][0].getPiece() == nullptr);
-    EXPECT_FALSE(b[0][0].getPiece() == nullptr);
+    EXPECT_TRUE(b[4][0].getPiece() == NO_PIECE);
+    EXPECT_FALSE(b[0][0].getPiece() == NO_PIECE);
 
-    EXPECT_EQ(b[7][3].getPiece()->getID(), "wQ");
-    EXPECT_FALSE(b[7][6].getPiece()->getID() == "bK");
+    EXPECT_EQ(b[7][3].getPiece(), W_QUEEN);
+    EXPECT_FALSE(b[7][6].getPiece() == B_KING);
 }
 
 TEST(BoardTests, testClearBoard) {
@@ -152,6 +220,31 @@ TEST(BoardTests, fenGeneration) {
   
 }
 
+TEST(BoardTests, testBitboards) {
+    Board b("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    EXPECT_EQ(popCount(b.getOccupied()), 32);
+    EXPECT_EQ(popCount(b.getColorBitboard(WHITE)), 16);
+    EXPECT_EQ(popCount(b.getBitboard(BLACK, PAWN)), 8);
+    EXPECT_EQ(b.getBitboard(WHITE, KING), squareBB(squareIndex(7, 4)));
+    EXPECT_EQ(b.getPieceAt(squareIndex(0, 3)), B_QUEEN);
+    EXPECT_EQ(b.getPieceAt(squareIndex(4, 4)), NO_PIECE);
+
+    // Loading a new position must not leave pieces of the old one behind
+    b.loadFromFEN("4k3/8/8/8/8/8/8/4K3 w - - 0 1");
+    EXPECT_EQ(popCount(b.getOccupied()), 2);
+    EXPECT_TRUE(b[7][0].getPiece() == NO_PIECE);
+
+    // Moves keep the bitboards and mailbox in step
+    Board b1("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    std::tuple<int, int> start = std::make_tuple(6, 4);
+    std::tuple<int, int> end = std::make_tuple(4, 4);
+    b1.makeMove(Move(start, end, DOUBLE_PAWN_PUSH));
+    EXPECT_EQ(b1.getPieceAt(squareIndex(4, 4)), W_PAWN);
+    EXPECT_EQ(b1.getPieceAt(squareIndex(6, 4)), NO_PIECE);
+    EXPECT_EQ(popCount(b1.getOccupied()), 32);
+    EXPECT_EQ(b1.getHalfMove(), 0);
+}
+
 TEST(BoardTests, testSquareUnderAttack) {
     Board board("r1bqkbnr/pppp1ppp/2n5/1B2p3/4P3/5N2/PPPP1PPP/RNBQK2R b KQkq - 3 3");
     EXPECT_TRUE(board.squareUnderAttack(board[2][2]));
@@ -165,6 +258,59 @@ TEST(BoardTests, testSquareUnderAttack) {
 
 }
 
+TEST(BoardTests, testAttackersTo) {
+    Board board("r1bqkbnr/pppp1ppp/2n5/1B2p3/4P3/5N2/PPPP1PPP/RNBQK2R b KQkq - 3 3");
+
+    // e5 is attacked by the knight on f3 and defended by the knight on c6
+    int e5 = squareFromName("e5");
+    EXPECT_EQ(board.attackersTo(e5, WHITE), squareBB(squareFromName("f3")));
+    EXPECT_EQ(board.attackersTo(e5, BLACK), squareBB(squareFromName("c6")));
+    EXPECT_EQ(board.attackersTo(e5, board.getOccupied()), squareBB(squareFromName("f3")) | squareBB(squareFromName("c6")));
+
+    // The knight on c6 is attacked by the bishop on b5 and defended by the b7 and d7 pawns
+    int c6 = squareFromName("c6");
+    EXPECT_EQ(board.attackersTo(c6, WHITE), squareBB(squareFromName("b5")));
+    EXPECT_EQ(popCount(board.attackersTo(c6, BLACK)), 2);
+    EXPECT_TRUE(board.isAttacked(c6, WHITE));
+
+    // d7 is defended by the king, queen and bishop, and the knight blocks the bishop on b5
+    int d7 = squareFromName("d7");
+    EXPECT_EQ(popCount(board.attackersTo(d7, BLACK)), 3);
+    EXPECT_FALSE(board.isAttacked(d7, WHITE));
+
+    // Removing the c6 knight and d7 pawn from the occupancy shows the bishop x-ray to e8
+    int e8 = squareFromName("e8");
+    EXPECT_FALSE(board.isAttacked(e8, WHITE));
+    Bitboard withoutKnight = board.getOccupied() ^ squareBB(squareFromName("c6")) ^ squareBB(d7);
+    EXPECT_EQ(board.attackersTo(e8, withoutKnight) & board.getColorBitboard(WHITE), squareBB(squareFromName("b5")));
+
+    // isAttacked agrees with the attacking moves of the side to play on every empty or enemy square
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+    };
+    for (const char* fen : fens) {
+        Board b(fen);
+        Color us = b.getWhiteToPlay() ? WHITE : BLACK;
+        MoveList attacks;
+        b.getAttackingMoves(attacks);
+        for (int sq = 0; sq < 64; sq++) {
+            if (b.getColorBitboard(us) & squareBB(sq)) {
+                continue;
+            }
+            bool attacked = false;
+            for (Move move : attacks) {
+                if (move.to() == sq) {
+                    attacked = true;
+                }
+            }
+            EXPECT_EQ(b.isAttacked(sq, us), attacked) << fen << " " << squareName(sq);
+            EXPECT_EQ(b.attackersTo(sq, us) != 0, attacked) << fen << " " << squareName(sq);
+        }
+    }
+}
+
 TEST(BoardTests, testPinsAndChecksStartingPosition) {
     Board b("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
     std::tuple<bool, std::vector<Pin>, std::vector<Check> > pinsAndChecks = b.getPinsAndChecks();
@@ -215,41 +361,49 @@ TEST(BoardTests, testPinsAndChecksKnight) {
 
 TEST(PieceTestsQueen, testGetValidMoves) {
     Board b("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
-    std::vector<Move> moves = b[7][3].getPiece()->getValidMoves(&b);
+    MoveList moves;
+    b.generatePieceMoves(squareIndex(7, 3), moves);
 
     EXPECT_EQ(moves.size(), 0);
 
     Board b1("rnbqkbnr/pppppppp/8/8/8/4P3/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
-    std::vector<Move> m = b1[7][3].getPiece()->getValidMoves(&b1);
+    MoveList m;
+    b1.generatePieceMoves(squareIndex(7, 3), m);
 
     EXPECT_EQ(m.size(), 4);
 
     Board b2("rnbqkbnr/ppppp1pp/8/8/P7/4Pp2/1PPP1PPP/RNBQKBNR w KQkq - 0 4");
-    std::vector<Move> ms = b2[7][3].getPiece()->getValidMoves(&b2);
+    MoveList ms;
+    b2.generatePieceMoves(squareIndex(7, 3), ms);
 
     EXPECT_EQ(ms.size(), 2);
 
     Board b3("8/8/8/4Q3/8/8/8/8 w - - 0 1");
-    std::vector<Move> ms2 = b3[3][4].getPiece()->getValidMoves(&b3);
+    MoveList ms2;
+    b3.generatePieceMoves(squareIndex(3, 4), ms2);
 
     EXPECT_EQ(ms2.size(), 27);
 
     Board board("r1b1k1nr/pppp1qpp/2n5/b7/4P3/1QPp1N2/P4PPP/RNB2RK1 w kq - 0 10");
 
-    std::vector<Move> ms1 = board[5][1].getPiece()->getValidMoves(&board);
+    MoveList ms1;
+    board.generatePieceMoves(squareIndex(5, 1), ms1);
 
     EXPECT_EQ(ms1.size(), 13);
 }
 
 TEST(PieceTestsKing, testGetValidMoves) {
     Board b("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
-    std::vector<Move> moves = b[7][4].getPiece()->getValidMoves(&b);
+    MoveList moves;
+    b.generatePieceMoves(squareIndex(7, 4), moves);
 
     EXPECT_EQ(moves.size(), 0);
 
     Board b1("5k2/8/8/8/3K4/8/8/8 w - - 0 1");
-    std::vector<Move> moves1 = b1[4][3].getPiece()->getValidMoves(&b1);
-    std::vector<Move> movesBK = b1[0][5].getPiece()->getValidMoves(&b1);
+    MoveList moves1;
+    b1.generatePieceMoves(squareIndex(4, 3), moves1);
+    MoveList movesBK;
+    b1.generatePieceMoves(squareIndex(0, 5), movesBK);
     
     EXPECT_EQ(moves1.size(), 8);
     EXPECT_EQ(movesBK.size(), 5);
@@ -257,10 +411,14 @@ TEST(PieceTestsKing, testGetValidMoves) {
 
 TEST(PieceTestsRook, testGetValidMoves) {
     Board b("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
-    std::vector<Move> movesA8 = b[0][0].getPiece()->getValidMoves(&b);
-    std::vector<Move> movesH8 = b[0][7].getPiece()->getValidMoves(&b);
-    std::vector<Move> movesA1 = b[7][0].getPiece()->getValidMoves(&b);
-    std::vector<Move> movesH1 = b[7][7].getPiece()->getValidMoves(&b);
+    MoveList movesA8;
+    b.generatePieceMoves(squareIndex(0, 0), movesA8);
+    MoveList movesH8;
+    b.generatePieceMoves(squareIndex(0, 7), movesH8);
+    MoveList movesA1;
+    b.generatePieceMoves(squareIndex(7, 0), movesA1);
+    MoveList movesH1;
+    b.generatePieceMoves(squareIndex(7, 7), movesH1);
 
     EXPECT_EQ(movesA8.size(), 0);
     EXPECT_EQ(movesH8.size(), 0);
@@ -268,10 +426,14 @@ TEST(PieceTestsRook, testGetValidMoves) {
     EXPECT_EQ(movesH1.size(), 0);
 
     Board b1("r1bqkb1r/1pppppp1/1n3n2/p6p/P6P/2N2N2/1PPPPPP1/R1BQKB1R w KQkq - 0 1");
-    movesA8 = b1[0][0].getPiece()->getValidMoves(&b1);
-    movesH8 = b1[0][7].getPiece()->getValidMoves(&b1);
-    movesA1 = b1[7][0].getPiece()->getValidMoves(&b1);
-    movesH1 = b1[7][7].getPiece()->getValidMoves(&b1);
+    movesA8.clear();
+    b1.generatePieceMoves(squareIndex(0, 0), movesA8);
+    movesH8.clear();
+    b1.generatePieceMoves(squareIndex(0, 7), movesH8);
+    movesA1.clear();
+    b1.generatePieceMoves(squareIndex(7, 0), movesA1);
+    movesH1.clear();
+    b1.generatePieceMoves(squareIndex(7, 7), movesH1);
 
     EXPECT_EQ(movesA8.size(), 3);
     EXPECT_EQ(movesH8.size(), 3);
@@ -279,10 +441,14 @@ TEST(PieceTestsRook, testGetValidMoves) {
     EXPECT_EQ(movesH1.size(), 3);
 
     Board b2("r1bqkb1r/1pppppp1/1n3n2/P6P/p6p/2N2N2/1PPPPPP1/R1BQKB1R w KQkq - 0 1");
-    movesA8 = b2[0][0].getPiece()->getValidMoves(&b2);
-    movesH8 = b2[0][7].getPiece()->getValidMoves(&b2);
-    movesA1 = b2[7][0].getPiece()->getValidMoves(&b2);
-    movesH1 = b2[7][7].getPiece()->getValidMoves(&b2);
+    movesA8.clear();
+    b2.generatePieceMoves(squareIndex(0, 0), movesA8);
+    movesH8.clear();
+    b2.generatePieceMoves(squareIndex(0, 7), movesH8);
+    movesA1.clear();
+    b2.generatePieceMoves(squareIndex(7, 0), movesA1);
+    movesH1.clear();
+    b2.generatePieceMoves(squareIndex(7, 7), movesH1);
 
     EXPECT_EQ(movesA8.size(), 4);
     EXPECT_EQ(movesH8.size(), 4);
@@ -292,10 +458,14 @@ TEST(PieceTestsRook, testGetValidMoves) {
 
 TEST(PieceTestsBishop, testGetValidMoves) {
     Board b("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
-    std::vector<Move> movesC8 = b[0][2].getPiece()->getValidMoves(&b);
-    std::vector<Move> movesF8 = b[0][5].getPiece()->getValidMoves(&b);
-    std::vector<Move> movesC1 = b[7][2].getPiece()->getValidMoves(&b);
-    std::vector<Move> movesF1 = b[7][5].getPiece()->getValidMoves(&b);
+    MoveList movesC8;
+    b.generatePieceMoves(squareIndex(0, 2), movesC8);
+    MoveList movesF8;
+    b.generatePieceMoves(squareIndex(0, 5), movesF8);
+    MoveList movesC1;
+    b.generatePieceMoves(squareIndex(7, 2), movesC1);
+    MoveList movesF1;
+    b.generatePieceMoves(squareIndex(7, 5), movesF1);
 
     EXPECT_EQ(movesC8.size(), 0);
     EXPECT_EQ(movesF8.size(), 0);
@@ -303,10 +473,14 @@ TEST(PieceTestsBishop, testGetValidMoves) {
     EXPECT_EQ(movesF1.size(), 0);
 
     Board b1("r1bqk1nr/p1p2ppp/1pnp4/2b1p3/2B1P3/1P1P1N2/P1P2PPP/RNBQK2R w KQkq - 0 1");
-    movesC8 = b1[0][2].getPiece()->getValidMoves(&b1);
-    std::vector<Move> movesC5 = b1[3][2].getPiece()->getValidMoves(&b1);
-    std::vector<Move> movesC4 = b1[4][2].getPiece()->getValidMoves(&b1);
-    movesC1 = b1[7][2].getPiece()->getValidMoves(&b1);
+    movesC8.clear();
+    b1.generatePieceMoves(squareIndex(0, 2), movesC8);
+    MoveList movesC5;
+    b1.generatePieceMoves(squareIndex(3, 2), movesC5);
+    MoveList movesC4;
+    b1.generatePieceMoves(squareIndex(4, 2), movesC4);
+    movesC1.clear();
+    b1.generatePieceMoves(squareIndex(7, 2), movesC1);
 
     EXPECT_EQ(movesC8.size(), 7);
     EXPECT_EQ(movesC5.size(), 5);
@@ -316,10 +490,14 @@ TEST(PieceTestsBishop, testGetValidMoves) {
 
 TEST(PieceTestsKnight, testGetValidMoves) {
     Board b("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
-    std::vector<Move> movesB8 = b[0][1].getPiece()->getValidMoves(&b);
-    std::vector<Move> movesG8 = b[0][6].getPiece()->getValidMoves(&b);
-    std::vector<Move> movesB1 = b[7][1].getPiece()->getValidMoves(&b);
-    std::vector<Move> movesG1 = b[7][6].getPiece()->getValidMoves(&b);
+    MoveList movesB8;
+    b.generatePieceMoves(squareIndex(0, 1), movesB8);
+    MoveList movesG8;
+    b.generatePieceMoves(squareIndex(0, 6), movesG8);
+    MoveList movesB1;
+    b.generatePieceMoves(squareIndex(7, 1), movesB1);
+    MoveList movesG1;
+    b.generatePieceMoves(squareIndex(7, 6), movesG1);
 
     EXPECT_EQ(movesB8.size(), 2);
     EXPECT_EQ(movesG8.size(), 2);
@@ -327,10 +505,14 @@ TEST(PieceTestsKnight, testGetValidMoves) {
     EXPECT_EQ(movesG1.size(), 2);
 
     Board b1("8/8/2N2n2/3n4/8/4N3/8/8 w - - 0 1");
-    std::vector<Move> movesC6 = b1[2][2].getPiece()->getValidMoves(&b1);
-    std::vector<Move> movesF6 = b1[2][5].getPiece()->getValidMoves(&b1);
-    std::vector<Move> movesD5 = b1[3][3].getPiece()->getValidMoves(&b1);
-    std::vector<Move> movesE3 = b1[5][4].getPiece()->getValidMoves(&b1);
+    MoveList movesC6;
+    b1.generatePieceMoves(squareIndex(2, 2), movesC6);
+    MoveList movesF6;
+    b1.generatePieceMoves(squareIndex(2, 5), movesF6);
+    MoveList movesD5;
+    b1.generatePieceMoves(squareIndex(3, 3), movesD5);
+    MoveList movesE3;
+    b1.generatePieceMoves(squareIndex(5, 4), movesE3);
 
     EXPECT_EQ(movesC6.size(), 8);
     EXPECT_EQ(movesF6.size(), 7);
@@ -341,70 +523,512 @@ TEST(PieceTestsKnight, testGetValidMoves) {
 TEST(PieceTestsPawn, testGetValidMoves) {
     Board b("8/8/8/8/8/8/P7/8 w - - 0 1");
 
-    std::vector<Move> movesA2 = b[6][0].getPiece()->getValidMoves(&b);
+    MoveList movesA2;
+    b.generatePieceMoves(squareIndex(6, 0), movesA2);
 
     EXPECT_EQ(movesA2.size(), 2);
 
     Board b1("8/8/8/8/8/2p5/2P5/8 w - - 0 1");
-    std::vector<Move> movesC2 = b1[6][2].getPiece()->getValidMoves(&b1);
+    MoveList movesC2;
+    b1.generatePieceMoves(squareIndex(6, 2), movesC2);
 
     EXPECT_EQ(movesC2.size(), 0);
 
     Board b2("8/8/8/8/8/1p1N4/2P5/8 w - - 0 1");
-    movesC2 = b2[6][2].getPiece()->getValidMoves(&b2);
+    movesC2.clear();
+    b2.generatePieceMoves(squareIndex(6, 2), movesC2);
 
     EXPECT_EQ(movesC2.size(), 3);
 
     Board b3("8/8/8/8/2N5/1prp4/2P5/8 w - - 0 1");
-    movesC2 = b3[6][2].getPiece()->getValidMoves(&b3);
+    movesC2.clear();
+    b3.generatePieceMoves(squareIndex(6, 2), movesC2);
 
     EXPECT_EQ(movesC2.size(), 2);
 }
 
 TEST(PieceTestsPawn, testGetAttackingMoves) {
     Board board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
-    std::vector<Move> moves = board[6][1].getPiece()->getAttackingMoves(&board);
+    MoveList moves;
+    board.generatePieceAttackingMoves(squareIndex(6, 1), moves);
 
     EXPECT_EQ(moves.size(), 2);
 
-    moves = board[6][0].getPiece()->getAttackingMoves(&board);
+    moves.clear();
+
+    board.generatePieceAttackingMoves(squareIndex(6, 0), moves);
     EXPECT_EQ(moves.size(), 1);
 
 }
 
+// Reference slider attacks computed by walking each ray one square at a time
+static Bitboard rayAttacks(int sq, Bitboard occupied, const int directions[][2], int count) {
+    Bitboard attacks = 0;
+    for (int d = 0; d < count; d++) {
+        int rank = rankOf(sq) + directions[d][0];
+        int file = fileOf(sq) + directions[d][1];
+        while (0 <= rank && rank < 8 && 0 <= file && file < 8) {
+            attacks |= squareBB(squareIndex(rank, file));
+            if (occupied & squareBB(squareIndex(rank, file)))
+                break;
+            rank += directions[d][0];
+            file += directions[d][1];
+        }
+    }
+    return attacks;
+}
+
+TEST(BitboardTests, testSliderAttacks) {
+    initBitboards();
+    SliderAttackPath hostPath = sliderAttackPath;
+    const int rookDirections[4][2] = { {1, 0}, {0, 1}, {-1, 0}, {0, -1} };
+    const int bishopDirections[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+
+    // Check the magic path everywhere and the PEXT path on hosts that can run it
+    SliderAttackPath paths[2] = { MAGIC_ATTACKS, PEXT_ATTACKS };
+    for (SliderAttackPath path : paths) {
+        if (setSliderAttackPath(path) != path)
+            continue;
+
+        uint64_t seed = 0x123456789ABCDEFULL;
+        for (int i = 0; i < 2000; i++) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            Bitboard occupied = seed & (seed >> 9);
+            for (int sq = 0; sq < 64; sq++) {
+                EXPECT_EQ(rookAttacks(sq, occupied), rayAttacks(sq, occupied, rookDirections, 4));
+                EXPECT_EQ(bishopAttacks(sq, occupied), rayAttacks(sq, occupied, bishopDirections, 4));
+            }
+        }
+
+        // An empty board gives 14 rook squares everywhere and 27 queen squares in the center
+        EXPECT_EQ(popCount(rookAttacks(squareIndex(0, 0), 0)), 14);
+        EXPECT_EQ(popCount(queenAttacks(squareIndex(3, 3), 0)), 27);
+    }
+
+    setSliderAttackPath(hostPath);
+    EXPECT_EQ(sliderAttackPath, hostPath);
+}
+
+TEST(BitboardTests, testShift) {
+    initBitboards();
+
+    // Shifting every square one step matches the pawn attack tables, which never wrap around the board
+    for (int sq = 0; sq < 64; sq++) {
+        if (rankOf(sq) != 0) {
+            EXPECT_EQ(shift<-9>(squareBB(sq)) | shift<-7>(squareBB(sq)), pawnAttacks(WHITE, sq));
+            EXPECT_EQ(shift<-8>(squareBB(sq)), squareBB(sq - 8));
+        }
+        if (rankOf(sq) != 7) {
+            EXPECT_EQ(shift<7>(squareBB(sq)) | shift<9>(squareBB(sq)), pawnAttacks(BLACK, sq));
+            EXPECT_EQ(shift<8>(squareBB(sq)), squareBB(sq + 8));
+        }
+    }
+
+    // Squares pushed off the board are dropped
+    EXPECT_EQ(shift<-8>(rankBB(0)), 0);
+    EXPECT_EQ(shift<9>(FileHBB), 0);
+    EXPECT_EQ(shift<-9>(FileABB), 0);
+}
+
 TEST(MoveGenerationTests, testMoveGeneration) {
     Board b("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
-    std::vector<Move> moves = b.generateMoves();
+    MoveList moves;
+    b.generateMoves(moves);
 
     EXPECT_EQ(moves.size(), 20);
 
     b.makeMove(moves[0]);
 
-    moves = b.generateMoves();
+    b.generateMoves(moves);
 
     EXPECT_FALSE(b.getWhiteToPlay());
     EXPECT_EQ(moves.size(), 20);
 
     Board b1("rnbqkbnr/p3pppp/2p5/1p1p4/3PP3/2N5/PPP2PPP/R1BQKBNR w KQkq - 0 4");
-    moves = b1.generateMoves();
+    b1.generateMoves(moves);
 
     b1.makeMove(moves[0]);
-    moves = b1.generateMoves();
+    b1.generateMoves(moves);
  
 }
 
+TEST(MoveGenerationTests, testLegalMoves) {
+    // A pinned knight can not move, leaving the 5 king moves. A pinned bishop moves only along the pin
+    Board b("4k3/4r3/8/8/8/4N3/8/4K3 w - - 0 1");
+    MoveList moves;
+    b.generateMoves(moves);
+    EXPECT_EQ(moves.size(), 5);
+
+    Board b1("4k3/8/8/b7/8/8/3B4/4K3 w - - 0 1");
+    b1.generateMoves(moves);
+    for (Move move : moves) {
+        if (move.from() == squareFromName("d2")) {
+            EXPECT_TRUE(move.to() == squareFromName("c3") || move.to() == squareFromName("b4") || move.to() == squareFromName("a5"));
+        }
+    }
+
+    // Double check: only king moves
+    Board b2("4k3/8/8/8/1b6/8/4r3/3NK3 w - - 0 1");
+    EXPECT_EQ(popCount(b2.getCheckers()), 2);
+    b2.generateMoves(moves);
+    for (Move move : moves) {
+        EXPECT_EQ(move.from(), squareFromName("e1"));
+    }
+
+    // En passant that would leave the king on an open rank is illegal
+    Board b3("8/8/8/K2pP2r/8/8/8/7k w - d6 0 1");
+    b3.generateMoves(moves);
+    EXPECT_FALSE(moves.contains(Move(squareFromName("e5"), squareFromName("d6"), EN_PASSANT)));
+
+    // Castling is not possible out of check, and queenside only needs b1 empty, not safe
+    Board b4("r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1");
+    b4.generateMoves(moves);
+    EXPECT_TRUE(moves.contains(Move(squareFromName("e8"), squareFromName("c8"), QUEEN_CASTLE)));
+    Board b5("1r2k3/8/8/8/8/8/8/R3K2R w KQ - 0 1");
+    b5.generateMoves(moves);
+    EXPECT_TRUE(moves.contains(Move(squareFromName("e1"), squareFromName("c1"), QUEEN_CASTLE)));
+    Board b6("4k3/8/8/8/8/8/4r3/R3K2R w KQ - 0 1");
+    EXPECT_TRUE(b6.inCheck());
+    b6.generateMoves(moves);
+    for (Move move : moves) {
+        EXPECT_FALSE(move.isCastle());
+    }
+}
+
+TEST(MoveGenerationTests, testPerft) {
+    // Known leaf counts from the chessprogramming wiki perft results
+    Board start;
+    EXPECT_EQ(start.perft(1), 20);
+    EXPECT_EQ(start.perft(2), 400);
+    EXPECT_EQ(start.perft(3), 8902);
+    EXPECT_EQ(start.perft(4), 197281);
+
+    Board kiwipete("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    EXPECT_EQ(kiwipete.perft(1), 48);
+    EXPECT_EQ(kiwipete.perft(2), 2039);
+    EXPECT_EQ(kiwipete.perft(3), 97862);
+
+    Board position3("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1");
+    EXPECT_EQ(position3.perft(4), 43238);
+    EXPECT_EQ(position3.perft(5), 674624);
+
+    Board position4("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    EXPECT_EQ(position4.perft(3), 9467);
+
+    Board position5("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8");
+    EXPECT_EQ(position5.perft(3), 62379);
+
+    // perft leaves the board as it found it
+    EXPECT_EQ(kiwipete.toFEN(), "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+}
+
+TEST(MoveGenerationTests, testColorSymmetry) {
+    // The generator is instantiated once per color, so a position and its color-flipped mirror
+    // must have the same move tree
+    Board white("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    Board black("r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1");
+    for (int depth = 1; depth <= 3; depth++) {
+        EXPECT_EQ(white.perft(depth), black.perft(depth));
+    }
+    EXPECT_EQ(black.perft(3), 9467);
+}
+
+TEST(MoveGenerationTests, testCapturesAndQuiets) {
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"
+    };
+    for (const char* fen : fens) {
+        Board b(fen);
+        MoveList all, captures, quiets;
+        b.generateMoves(all);
+        b.generateCaptures(captures);
+        b.generateQuiets(quiets);
+
+        // The two stages split the legal moves without overlap
+        EXPECT_EQ(captures.size() + quiets.size(), all.size()) << fen;
+        for (Move move : captures) {
+            EXPECT_TRUE(all.contains(move)) << fen << " " << move;
+            EXPECT_TRUE(move.isCapture() || move.isPromotion()) << fen << " " << move;
+        }
+        for (Move move : quiets) {
+            EXPECT_TRUE(all.contains(move)) << fen << " " << move;
+            EXPECT_FALSE(move.isCapture() || move.isPromotion()) << fen << " " << move;
+        }
+    }
+}
+
+TEST(MoveGenerationTests, testIsLegal) {
+    Board b("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    MoveList moves;
+    b.generateMoves(moves);
+    for (Move move : moves) {
+        EXPECT_TRUE(b.isLegal(move)) << move;
+    }
+
+    // A null move, an empty square, the opponent's piece, a wrong flag, and a move that does not exist
+    EXPECT_FALSE(b.isLegal(Move()));
+    EXPECT_FALSE(b.isLegal(Move(squareFromName("a3"), squareFromName("a4"))));
+    EXPECT_FALSE(b.isLegal(Move(squareFromName("a8"), squareFromName("b8"))));
+    EXPECT_FALSE(b.isLegal(Move(squareFromName("a2"), squareFromName("a4"))));
+    EXPECT_FALSE(b.isLegal(Move(squareFromName("a2"), squareFromName("a5"))));
+
+    // The pinned d7 pawn of this position may not move, and castling out of check is not allowed
+    Board pinned("4k3/3p4/8/1B6/8/8/8/4K2R b K - 0 1");
+    EXPECT_FALSE(pinned.isLegal(Move(squareFromName("d7"), squareFromName("d6"))));
+    Board check("4k3/8/8/8/8/8/4r3/R3K2R w KQ - 0 1");
+    EXPECT_FALSE(check.isLegal(Move(squareFromName("e1"), squareFromName("g1"), KING_CASTLE)));
+}
+
+TEST(MovePickerTests, testStages) {
+    Board b("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    MoveList all;
+    b.generateMoves(all);
+
+    Move hashMove(squareFromName("e1"), squareFromName("g1"), KING_CASTLE);
+    Move killer(squareFromName("a2"), squareFromName("a3"));
+    Move illegalKiller(squareFromName("a2"), squareFromName("a5"));
+    MovePicker picker(b, hashMove, killer, illegalKiller);
+
+    // Every legal move exactly once: the hash move first, then captures from the most valuable victim, then
+    // the killer, then the remaining quiet moves, then the captures losing material
+    MoveList picked;
+    for (Move move = picker.next(); !move.isNull(); move = picker.next()) {
+        EXPECT_FALSE(picked.contains(move)) << move;
+        picked.push_back(move);
+    }
+    EXPECT_EQ(picked.size(), all.size());
+    for (Move move : all) {
+        EXPECT_TRUE(picked.contains(move)) << move;
+    }
+    EXPECT_EQ(picked[0], hashMove);
+    int captures = 0;
+    while (picked[1 + captures].isCapture()) {
+        EXPECT_TRUE(b.seeGE(picked[1 + captures], 0)) << picked[1 + captures];
+        captures++;
+    }
+    EXPECT_EQ(picked[1 + captures], killer);
+    int badCaptures = 0;
+    for (int i = 2 + captures; i < picked.size(); i++) {
+        if (picked[i].isCapture()) {
+            EXPECT_FALSE(b.seeGE(picked[i], 0)) << picked[i];
+            badCaptures++;
+        }
+        else {
+            EXPECT_EQ(badCaptures, 0) << picked[i];
+        }
+    }
+    EXPECT_EQ(captures + badCaptures, 8);
+    EXPECT_GT(badCaptures, 0);
+
+    // The capture only picker stops after the captures that do not lose material
+    MovePicker capturesOnly(b, true);
+    int good = 0;
+    for (Move move = capturesOnly.next(); !move.isNull(); move = capturesOnly.next()) {
+        EXPECT_TRUE(move.isCapture()) << move;
+        good++;
+    }
+    EXPECT_EQ(good, 8 - badCaptures);
+
+    // Captures come from the most valuable victim down
+    EXPECT_GE(typeOf(b.getPieceAt(picked[1].to())), typeOf(b.getPieceAt(picked[captures].to())));
+
+    // An exhausted picker keeps returning null moves
+    EXPECT_TRUE(picker.next().isNull());
+
+    // An illegal hash move is skipped
+    MovePicker noHash(b, Move(squareFromName("a3"), squareFromName("a4")));
+    EXPECT_TRUE(noHash.next().isCapture());
+}
+
+TEST(MovePickerTests, testHistoryOrder) {
+    Board b;
+    History history;
+    Move best(squareFromName("g1"), squareFromName("f3"));
+    Move second(squareFromName("b2"), squareFromName("b3"));
+    Move counterMove(squareFromName("h2"), squareFromName("h3"));
+    history.update(W_KNIGHT, best, History::bonus(8));
+    history.update(W_PAWN, second, History::bonus(4));
+    history.update(W_PAWN, counterMove, -History::bonus(8));
+
+    // No captures in the starting position: the countermove comes first, then the quiet moves by history score
+    MovePicker picker(b, Move(), Move(), Move(), counterMove, &history);
+    EXPECT_EQ(picker.next(), counterMove);
+    EXPECT_EQ(picker.next(), best);
+    EXPECT_EQ(picker.next(), second);
+    int count = 3;
+    while (!picker.next().isNull()) {
+        count++;
+    }
+    EXPECT_EQ(count, 20);
+
+    // A countermove repeating a killer is returned once
+    MovePicker repeated(b, Move(), counterMove, Move(), counterMove, &history);
+    EXPECT_EQ(repeated.next(), counterMove);
+    EXPECT_EQ(repeated.next(), best);
+}
+
+TEST(HistoryTests, testGravity) {
+    History history;
+    Move move(squareFromName("e2"), squareFromName("e4"), DOUBLE_PAWN_PUSH);
+    EXPECT_EQ(history.score(W_PAWN, move), 0);
+
+    // Repeated bonuses saturate below the bound instead of growing without limit
+    for (int i = 0; i < 1000; i++) {
+        history.update(W_PAWN, move, History::bonus(20));
+    }
+    EXPECT_GT(history.score(W_PAWN, move), 0);
+    EXPECT_LE(history.score(W_PAWN, move), 2 * MAX_HISTORY);
+    for (int i = 0; i < 1000; i++) {
+        history.update(W_PAWN, move, -History::bonus(20));
+    }
+    EXPECT_LT(history.score(W_PAWN, move), 0);
+    EXPECT_GE(history.score(W_PAWN, move), -2 * MAX_HISTORY);
+
+    // The other color's table is separate
+    EXPECT_EQ(history.score(B_PAWN, Move(squareFromName("e7"), squareFromName("e5"), DOUBLE_PAWN_PUSH)), 0);
+
+    Move counter(squareFromName("g8"), squareFromName("f6"));
+    history.setCounterMove(W_PAWN, squareFromName("e4"), counter);
+    EXPECT_EQ(history.getCounterMove(W_PAWN, squareFromName("e4")), counter);
+    history.clear();
+    EXPECT_TRUE(history.getCounterMove(W_PAWN, squareFromName("e4")).isNull());
+    EXPECT_EQ(history.score(W_PAWN, move), 0);
+}
+
 TEST(MakeMoveTests, makeMove) {
     Board b("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
 
 
-    std::vector<Move> moves = b.generateMoves();
+    MoveList moves;
+    b.generateMoves(moves);
+    Piece pieceMoved = b.getSquare(moves[0].getStart()).getPiece();
     b.makeMove(moves[0]);
-    EXPECT_EQ(b.getSquare(moves[0].end).getPiece(), moves[0].pieceMoved);
-    EXPECT_TRUE(b.getSquare(moves[0].start).getPiece() == nullptr);
+    EXPECT_EQ(b.getSquare(moves[0].getEnd()).getPiece(), pieceMoved);
+    EXPECT_TRUE(b.getSquare(moves[0].getStart()).getPiece() == NO_PIECE);
     EXPECT_FALSE(b.getWhiteToPlay());
 }
 
 
+/**
+ * @brief Plays every generated move to depth plies and takes it back, checking the position
+ * (pieces, bitboards and game state) is restored after each unmakeMove.
+ */
+static void checkMakeUnmake(Board& board, int depth) {
+    if (depth == 0) {
+        return;
+    }
+    std::string fen = board.toFEN();
+    Key key = board.getKey();
+    Bitboard occupied = board.getOccupied();
+    std::tuple<int, int> whiteKing = board.whiteKingLocation;
+    std::tuple<int, int> blackKing = board.blackKingLocation;
+
+    MoveList moves;
+    board.generateMoves(moves);
+    for (Move move : moves) {
+        Piece piece = board.getPieceAt(move.from());
+        board.makeMove(move);
+        EXPECT_EQ(board.getKey(), board.computeKey()) << moveToString(move);
+        checkMakeUnmake(board, depth - 1);
+        board.unmakeMove(move);
+        EXPECT_EQ(board.getKey(), key) << moveToString(move);
+
+        EXPECT_EQ(board.toFEN(), fen) << moveToString(move);
+        EXPECT_EQ(board.getOccupied(), occupied) << moveToString(move);
+        EXPECT_EQ(board.getPieceAt(move.from()), piece) << moveToString(move);
+        EXPECT_TRUE(board.whiteKingLocation == whiteKing);
+        EXPECT_TRUE(board.blackKingLocation == blackKing);
+    }
+}
+
+TEST(MakeMoveTests, unmakeMove) {
+    Board b("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    checkMakeUnmake(b, 3);
+
+    // Castling both ways, captures and a pinned knight
+    Board b1("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    checkMakeUnmake(b1, 2);
+
+    // Promotions, with and without capture
+    Board b2("1n2k3/2P5/8/8/8/8/5p2/4K1N1 w - - 0 1");
+    checkMakeUnmake(b2, 2);
+
+    // En passant
+    Board b3("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 2");
+    checkMakeUnmake(b3, 2);
+    Move enPassant(squareFromName("e5"), squareFromName("d6"), EN_PASSANT);
+    b3.makeMove(enPassant);
+    EXPECT_EQ(b3.toFEN(), "4k3/8/3P4/8/8/8/8/4K3 b - - 0 2");
+    b3.unmakeMove(enPassant);
+    EXPECT_EQ(b3.toFEN(), "4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 2");
+}
+
+TEST(MakeMoveTests, castlingRightsUpdate) {
+    // Moving a rook loses the right to castle on its side only
+    Board b("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+    Move rookMove(squareFromName("h1"), squareFromName("h4"));
+    b.makeMove(rookMove);
+    EXPECT_EQ(b.getCastlingRights().toString(), "Qkq");
+    b.unmakeMove(rookMove);
+    EXPECT_EQ(b.getCastlingRights().toString(), "KQkq");
+
+    // Capturing a rook on its starting square loses the opponent's right on that side
+    Board b1("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+    b1.makeMove(Move(squareFromName("a1"), squareFromName("a8"), CAPTURE));
+    EXPECT_EQ(b1.getCastlingRights().toString(), "Kk");
+
+    // Moving the king loses both
+    Board b2("r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1");
+    b2.makeMove(Move(squareFromName("e8"), squareFromName("e7")));
+    EXPECT_EQ(b2.getCastlingRights().toString(), "KQ");
+}
+
+TEST(ZobristTests, testKeys) {
+    Board start;
+    Board b;
+    Key startKey = b.getKey();
+    EXPECT_EQ(startKey, b.computeKey());
+
+    // Moving the knights out and back transposes to the starting position
+    Move moves[4] = {
+        Move(squareFromName("g1"), squareFromName("f3")),
+        Move(squareFromName("g8"), squareFromName("f6")),
+        Move(squareFromName("f3"), squareFromName("g1")),
+        Move(squareFromName("f6"), squareFromName("g8"))
+    };
+    for (int i = 0; i < 3; i++) {
+        b.makeMove(moves[i]);
+        EXPECT_NE(b.getKey(), startKey);
+    }
+    b.makeMove(moves[3]);
+    EXPECT_EQ(b.getKey(), startKey);
+
+    // Same pieces but different move counts are different boards
+    EXPECT_FALSE(b == start);
+
+    // Active color, castling rights and en passant target are all part of the key
+    Board white("4k3/8/8/8/8/8/8/R3K3 w Q - 0 1");
+    Board black("4k3/8/8/8/8/8/8/R3K3 b Q - 0 1");
+    Board noCastling("4k3/8/8/8/8/8/8/R3K3 w - - 0 1");
+    EXPECT_NE(white.getKey(), black.getKey());
+    EXPECT_NE(white.getKey(), noCastling.getKey());
+
+    Board e4("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+    Board e4NoTarget("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
+    EXPECT_NE(e4.getKey(), e4NoTarget.getKey());
+
+    // The incremental key matches the key of the loaded FEN
+    Board played;
+    played.makeMove(Move(squareFromName("e2"), squareFromName("e4"), DOUBLE_PAWN_PUSH));
+    EXPECT_EQ(played.getKey(), e4.getKey());
+    EXPECT_TRUE(played == e4);
+}
+
 TEST(CastlingRightsTest, testToString) {
     CastlingRights cr(true, true, true, true);
     EXPECT_EQ(cr.toString(), "KQkq");
@@ -440,10 +1064,11 @@ TEST(CastlingRightsTest, testToString) {
 TEST(CastlingTests, whiteKingSide) {
     Board board("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4");
     Board check("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQ1RK1 b kq - 5 4");
-    std::vector<Move> moves = board.generateMoves();
+    MoveList moves;
+    board.generateMoves(moves);
 
     for (Move move : moves) {
-        if (move.isCastleMove) {
+        if (move.isCastle()) {
             board.makeMove(move);
             break;
         }
@@ -456,10 +1081,11 @@ TEST(CastlingTests, whiteKingSide) {
 TEST(CastlingTests, whiteQueenSide) {
     Board board("rnbqkb1r/1ppppppp/p4n2/6B1/3P4/2N5/PPPQPPPP/R3KBNR w KQq - 5 5");
     Board check("rnbqkb1r/1ppppppp/p4n2/6B1/3P4/2N5/PPPQPPPP/2KR1BNR b q - 6 5");
-    std::vector<Move> moves = board.generateMoves();
+    MoveList moves;
+    board.generateMoves(moves);
     
     for (Move move : moves) {
-        if (move.isCastleMove) {
+        if (move.isCastle()) {
             board.makeMove(move);
             break;
         }
@@ -473,10 +1099,11 @@ TEST(CastlingTests, whiteQueenSide) {
 TEST(CastlingTests, blackKingSide) {
     Board board("3rk2r/ppqnbpp1/2p1pn1p/7P/2PP4/5NN1/PP1BQPP1/1K1R3R b k - 6 17");
     Board check("3r1rk1/ppqnbpp1/2p1pn1p/7P/2PP4/5NN1/PP1BQPP1/1K1R3R w - - 7 18");
-    std::vector<Move> moves = board.generateMoves();
+    MoveList moves;
+    board.generateMoves(moves);
     
     for (Move move : moves) {
-        if (move.isCastleMove) {
+        if (move.isCastle()) {
             board.makeMove(move);
             break;
         }
@@ -490,10 +1117,11 @@ TEST(CastlingTests, blackKingSide) {
 TEST(CastlingTests, blackQueenSide) {
     Board board("r3kr2/ppqnbpp1/2p1pn1p/7P/2PP4/P2Q1NN1/1P1B1PP1/1K1R3R b q - 0 17");
     Board check("2kr1r2/ppqnbpp1/2p1pn1p/7P/2PP4/P2Q1NN1/1P1B1PP1/1K1R3R w - - 1 18");
-    std::vector<Move> moves = board.generateMoves();
+    MoveList moves;
+    board.generateMoves(moves);
     
     for (Move move : moves) {
-        if (move.isCastleMove) {
+        if (move.isCastle()) {
             board.makeMove(move);
             break;
         }
@@ -503,3 +1131,728 @@ TEST(CastlingTests, blackQueenSide) {
     EXPECT_FALSE(board.getCastlingRights().blackKingSide);
     EXPECT_FALSE(board.getCastlingRights().blackQueenSide);
 }
+
+TEST(SearchTests, testMate) {
+    // Back rank mate in one
+    Board mateIn1("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+    SearchLimits limits;
+    limits.depth = 3;
+    Search search(mateIn1);
+    SearchResult result = search.run(limits);
+    EXPECT_EQ(result.bestMove, Move(squareFromName("a1"), squareFromName("a8")));
+    EXPECT_EQ(result.score, VALUE_MATE - 1);
+    EXPECT_EQ(result.pv.size(), 1);
+
+    // Mate in two with the rook, scored as mate in 3 plies. The quiescence search sees the mated side in check
+    // with no evasions at depth 3, and the search stops there
+    Board mateIn2("7k/8/5K2/8/8/8/8/R7 w - - 0 1");
+    Search search2(mateIn2);
+    limits.depth = 6;
+    result = search2.run(limits);
+    EXPECT_EQ(result.score, VALUE_MATE - 3);
+    EXPECT_EQ(result.depth, 3);
+    EXPECT_EQ(result.pv.size(), 3);
+
+    // The mated side has no move and scores the mate against itself
+    Board mated("R5k1/5ppp/8/8/8/8/8/6K1 b - - 0 1");
+    Search search3(mated);
+    result = search3.run(limits);
+    EXPECT_TRUE(result.bestMove.isNull());
+    EXPECT_EQ(result.score, -VALUE_MATE);
+}
+
+TEST(SearchTests, testStalemate) {
+    Board b("k7/8/1Q6/8/8/8/8/7K b - - 0 1");
+    SearchLimits limits;
+    limits.depth = 2;
+    Search search(b);
+    SearchResult result = search.run(limits);
+    EXPECT_TRUE(result.bestMove.isNull());
+    EXPECT_EQ(result.score, VALUE_DRAW);
+}
+
+TEST(SearchTests, testMaterial) {
+    // The black queen on d5 is undefended
+    Board b("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1");
+    SearchLimits limits;
+    limits.depth = 2;
+    Search search(b);
+    SearchResult result = search.run(limits);
+    EXPECT_EQ(result.bestMove, Move(squareFromName("d2"), squareFromName("d5"), CAPTURE));
+    EXPECT_GT(result.score, 0);
+}
+
+TEST(SearchTests, testPrincipalVariation) {
+    const std::string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    Board b(fen);
+    SearchLimits limits;
+    limits.depth = 4;
+    Search search(b);
+    SearchResult result = search.run(limits);
+
+    // The search leaves the board as it found it, and the PV is a line of legal moves starting with the best move
+    EXPECT_EQ(b.toFEN(), fen);
+    EXPECT_EQ(result.depth, 4);
+    ASSERT_FALSE(result.pv.empty());
+    EXPECT_EQ(result.pv[0], result.bestMove);
+    for (Move move : result.pv) {
+        EXPECT_TRUE(b.isLegal(move)) << move;
+        b.makeMove(move);
+    }
+    for (int i = int(result.pv.size()) - 1; i >= 0; i--) {
+        b.unmakeMove(result.pv[i]);
+    }
+    EXPECT_EQ(b.toFEN(), fen);
+}
+
+TEST(SearchTests, testPrincipalVariationLength) {
+    // Table hits do not end PV nodes, so in positions without a forced end the PV reaches the full depth, even
+    // when the table is full of earlier searches of the position. Quiescence captures may add to it
+    const std::string fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    };
+    for (const std::string& fen : fens) {
+        Board b(fen);
+        Search search(b);
+        for (int depth = 1; depth <= 10; depth++) {
+            SearchLimits limits;
+            limits.depth = depth;
+            SearchResult result = search.run(limits);
+
+            EXPECT_EQ(result.depth, depth) << fen;
+            EXPECT_GE(int(result.pv.size()), depth) << fen;
+        }
+    }
+}
+
+TEST(SearchTests, testNodeLimit) {
+    const std::string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    Board b(fen);
+    SearchLimits limits;
+    limits.nodes = 5000;
+    Search search(b);
+    SearchResult result = search.run(limits);
+
+    EXPECT_LE(result.nodes, 5000);
+    EXPECT_GE(result.depth, 1);
+    EXPECT_FALSE(result.bestMove.isNull());
+    EXPECT_EQ(b.toFEN(), fen);
+
+    // Even a budget too small for one iteration returns a legal move
+    limits.nodes = 3;
+    result = search.run(limits);
+    EXPECT_EQ(result.depth, 0);
+    EXPECT_TRUE(b.isLegal(result.bestMove));
+}
+
+TEST(BoardTests, testRepetition) {
+    Board b;
+    Move knightOut(squareFromName("g1"), squareFromName("f3"));
+    Move knightBack(squareFromName("f3"), squareFromName("g1"));
+    Move blackOut(squareFromName("g8"), squareFromName("f6"));
+    Move blackBack(squareFromName("f6"), squareFromName("g8"));
+
+    EXPECT_FALSE(b.isRepetition());
+    b.makeMove(knightOut);
+    b.makeMove(blackOut);
+    b.makeMove(knightBack);
+    EXPECT_FALSE(b.isRepetition());
+    b.makeMove(blackBack);
+    EXPECT_TRUE(b.isRepetition());
+    b.unmakeMove(blackBack);
+    EXPECT_FALSE(b.isRepetition());
+}
+
+TEST(BoardTests, testSeeGE) {
+    // Pawn takes a knight defended by a pawn: wins a knight for a pawn
+    Board b("4k3/8/3p4/4n3/3P4/8/8/4K3 w - - 0 1");
+    Move pxn(squareFromName("d4"), squareFromName("e5"), CAPTURE);
+    EXPECT_TRUE(b.seeGE(pxn, 0));
+    EXPECT_TRUE(b.seeGE(pxn, PieceValue[KNIGHT] - PieceValue[PAWN]));
+    EXPECT_FALSE(b.seeGE(pxn, PieceValue[KNIGHT] - PieceValue[PAWN] + 1));
+
+    // Queen takes a pawn defended by a pawn: loses the queen
+    Board c("4k3/8/3p4/4p3/8/8/4Q3/4K3 w - - 0 1");
+    Move qxp(squareFromName("e2"), squareFromName("e5"), CAPTURE);
+    EXPECT_FALSE(c.seeGE(qxp, 0));
+
+    // Rook takes a rook defended by a rook, with a second white rook behind the first: the x-ray wins a rook
+    Board d("3r3k/3r4/8/8/8/8/3R4/3RK3 w - - 0 1");
+    Move rxr(squareFromName("d2"), squareFromName("d7"), CAPTURE);
+    EXPECT_TRUE(d.seeGE(rxr, PieceValue[ROOK]));
+    EXPECT_FALSE(d.seeGE(rxr, PieceValue[ROOK] + 1));
+
+    // Quiet move to a square attacked by a pawn
+    Board e("4k3/8/3p4/8/8/8/8/2N1K3 w - - 0 1");
+    Move quiet(squareFromName("c1"), squareFromName("e2"));
+    EXPECT_TRUE(e.seeGE(quiet, 0));
+    Board f("4k3/8/8/3p4/8/8/8/2N1K3 w - - 0 1");
+    Move hanging(squareFromName("c1"), squareFromName("b3"));
+    EXPECT_TRUE(f.seeGE(hanging, 0));
+    Move attacked(squareFromName("c1"), squareFromName("e2"));
+    EXPECT_TRUE(f.seeGE(attacked, 0));
+    Board g("4k3/8/8/8/3p4/8/8/2N1K3 w - - 0 1");
+    Move intoPawn(squareFromName("c1"), squareFromName("e3"));
+    EXPECT_FALSE(g.seeGE(intoPawn, 0));
+}
+
+TEST(BoardTests, testSee) {
+    // Undefended knight
+    Board a("4k3/8/8/4n3/8/8/8/4R1K1 w - - 0 1");
+    EXPECT_EQ(a.see(Move(squareFromName("e1"), squareFromName("e5"), CAPTURE)), PieceValue[KNIGHT]);
+
+    // Queen takes a defended pawn and is lost
+    Board b("4k3/8/3p4/4p3/8/8/4Q3/4K3 w - - 0 1");
+    EXPECT_EQ(b.see(Move(squareFromName("e2"), squareFromName("e5"), CAPTURE)), PieceValue[PAWN] - PieceValue[QUEEN]);
+
+    // Rook takes a rook defended by a rook, with a white rook behind it on the file: the x-ray wins a rook
+    Board c("3r3k/3r4/8/8/8/8/3R4/3RK3 w - - 0 1");
+    EXPECT_EQ(c.see(Move(squareFromName("d2"), squareFromName("d7"), CAPTURE)), PieceValue[ROOK]);
+
+    // The queen behind the bishop on the diagonal joins after the bishop recaptures. Black's knight on e5 is
+    // defended by the pawn on d6 only, and the recapturing pawn is taken by the queen: bishop for knight and pawn
+    Board d("4k3/8/3p4/4n3/8/2B5/1Q6/4K3 w - - 0 1");
+    EXPECT_EQ(d.see(Move(squareFromName("c3"), squareFromName("e5"), CAPTURE)),
+        PieceValue[KNIGHT] - PieceValue[BISHOP] + PieceValue[PAWN]);
+
+    // The king may not recapture on a square the opponent still attacks
+    Board e("4k3/4r3/8/8/8/8/4R3/4RK2 w - - 0 1");
+    EXPECT_EQ(e.see(Move(squareFromName("e2"), squareFromName("e7"), CAPTURE)), PieceValue[ROOK]);
+
+    // En passant wins a pawn, and a quiet move into a pawn's attack loses the piece
+    Board f("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+    EXPECT_EQ(f.see(Move(squareFromName("e5"), squareFromName("d6"), EN_PASSANT)), PieceValue[PAWN]);
+    Board g("4k3/8/8/8/3p4/8/8/2N1K3 w - - 0 1");
+    EXPECT_EQ(g.see(Move(squareFromName("c1"), squareFromName("e3"))), -PieceValue[KNIGHT]);
+
+    // A capture promotion wins the rook and the queen less the pawn
+    Board i("r3k3/1P6/8/8/8/8/8/4K3 w - - 0 1");
+    Move bxa8(squareFromName("b7"), squareFromName("a8"), QUEEN_PROMOTION_CAPTURE);
+    EXPECT_EQ(i.see(bxa8), PieceValue[ROOK] + PieceValue[QUEEN] - PieceValue[PAWN]);
+    EXPECT_TRUE(i.seeGE(bxa8, PieceValue[ROOK] + PieceValue[QUEEN] - PieceValue[PAWN]));
+
+    // A push promotion onto a defended square loses the pawn, and the capture only picker drops it
+    Board j("1r2k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+    Move a8q(squareFromName("a7"), squareFromName("a8"), QUEEN_PROMOTION);
+    EXPECT_EQ(j.see(a8q), -PieceValue[PAWN]);
+    EXPECT_FALSE(j.seeGE(a8q, 0));
+    MovePicker picker(j, true);
+    for (Move move = picker.next(); !move.isNull(); move = picker.next()) {
+        EXPECT_NE(move.to(), squareFromName("a8")) << move;
+    }
+
+    // A pawn recapturing on the last rank promotes
+    Board k("4k3/8/8/8/8/8/p6K/1n4R1 w - - 0 1");
+    Move rxb1(squareFromName("g1"), squareFromName("b1"), CAPTURE);
+    EXPECT_EQ(k.see(rxb1), PieceValue[KNIGHT] - PieceValue[ROOK] - PieceValue[QUEEN] + PieceValue[PAWN]);
+    EXPECT_FALSE(k.seeGE(rxb1, 0));
+
+    // seeGE agrees with see for every capture and promotion of crowded middlegame positions
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"
+    };
+    for (const char* fen : fens) {
+        Board h(fen);
+        MoveList captures;
+        h.generateCaptures(captures);
+        for (Move move : captures) {
+            int value = h.see(move);
+            EXPECT_TRUE(h.seeGE(move, value)) << fen << " " << move;
+            EXPECT_FALSE(h.seeGE(move, value + 1)) << fen << " " << move;
+        }
+    }
+}
+
+TEST(SearchTests, testQuiescence) {
+    // At depth 1 the queen seems to win a pawn, but the quiescence search sees the pawn recapture
+    Board b("4k3/8/3p4/4p3/8/8/4Q3/4K3 w - - 0 1");
+    SearchLimits limits;
+    limits.depth = 1;
+    Search search(b);
+    SearchResult result = search.run(limits);
+    EXPECT_NE(result.bestMove, Move(squareFromName("e2"), squareFromName("e5"), CAPTURE));
+    EXPECT_GT(result.score, 0);
+    EXPECT_LT(result.score, PieceValue[QUEEN]);
+}
+
+TEST(SearchTests, testPrincipalVariationSearch) {
+    const std::string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    Board b(fen);
+    SearchLimits limits;
+    limits.depth = 7;
+    Search search(b);
+    SearchResult result = search.run(limits);
+
+    // Null window searches of the later moves sometimes fail high and are searched again, the statistics of
+    // the result match the Search's
+    EXPECT_EQ(result.depth, 7);
+    EXPECT_GT(result.stats.pvsResearches, 0);
+    EXPECT_EQ(result.stats.pvsResearches, search.getStats().pvsResearches);
+    EXPECT_EQ(result.stats.aspirationFailLows + result.stats.aspirationFailHighs,
+        search.getStats().aspirationFailLows + search.getStats().aspirationFailHighs);
+    EXPECT_EQ(b.toFEN(), fen);
+
+    // A root score far from the previous iteration's fails the aspiration window high. White mates in three:
+    // the score jumps from the material balance to mate once the mate is seen, and the window widens to it
+    Board mate("6k1/8/8/5K2/8/8/8/R7 w - - 0 1");
+    Search mateSearch(mate);
+    limits.depth = 12;
+    SearchResult mateResult = mateSearch.run(limits);
+    EXPECT_EQ(mateResult.score, VALUE_MATE - 5);
+    EXPECT_GT(mateResult.stats.aspirationFailHighs, 0);
+}
+
+TEST(TimeManagerTests, testAllocation) {
+    TimeManager tm;
+    SearchLimits limits;
+    tm.start(limits, true);
+    EXPECT_FALSE(tm.isLimited());
+    EXPECT_FALSE(tm.hardLimitReached());
+    EXPECT_FALSE(tm.softLimitReached(0, 0));
+
+    // A fixed move time is used in full, less the overhead
+    limits.movetime = 1000;
+    tm.start(limits, true);
+    EXPECT_TRUE(tm.isLimited());
+    EXPECT_EQ(tm.getMaximum(), tm.getOptimum());
+    EXPECT_GT(tm.getMaximum(), 900);
+    EXPECT_LT(tm.getMaximum(), 1000);
+    EXPECT_FALSE(tm.softLimitReached(10, 0));
+
+    // A clock is shared over the moves to go, with room to overrun the share but not the clock
+    limits.movetime = 0;
+    limits.wtime = 60000;
+    limits.btime = 1000;
+    tm.start(limits, true);
+    EXPECT_GT(tm.getOptimum(), 60000 / 50);
+    EXPECT_LT(tm.getOptimum(), 60000 / 20);
+    EXPECT_GT(tm.getMaximum(), tm.getOptimum());
+    EXPECT_LT(tm.getMaximum(), 60000);
+    tm.start(limits, false);
+    EXPECT_LT(tm.getMaximum(), 1000);
+
+    // Increments and a near time control add to the share
+    int64_t base = tm.getOptimum();
+    limits.binc = 500;
+    tm.start(limits, false);
+    EXPECT_GT(tm.getOptimum(), base);
+    limits.binc = 0;
+    limits.movestogo = 2;
+    tm.start(limits, false);
+    EXPECT_GT(tm.getOptimum(), base);
+    EXPECT_LT(tm.getMaximum(), 1000);
+}
+
+TEST(TimeManagerTests, testStability) {
+    SearchLimits limits;
+    limits.wtime = 1000;
+    limits.movestogo = 1;
+    TimeManager tm;
+    tm.start(limits, true);
+
+    // Half way to the optimum, a settled best move stops, a changing one or a falling score goes on
+    std::this_thread::sleep_for(std::chrono::milliseconds(tm.getOptimum() * 6 / 10));
+    EXPECT_TRUE(tm.softLimitReached(8, 0));
+    EXPECT_FALSE(tm.softLimitReached(0, 0));
+    EXPECT_FALSE(tm.softLimitReached(8, 100));
+    EXPECT_FALSE(tm.hardLimitReached());
+}
+
+TEST(SearchTests, testTimeLimit) {
+    const std::string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    SearchLimits limits;
+    limits.movetime = 100;
+
+    // The hard limit stops the search in the middle of an iteration, with a move to play. A fixed move time has
+    // no soft limit, so the search can not return before the hard limit. How far a loaded machine runs past the
+    // deadline is not up to the search, so the overshoot is measured in nodes: the clock is read every 1024
+    // nodes, and once it has run out no further node is searched
+    Board b(fen);
+    Search search(b);
+    auto start = std::chrono::steady_clock::now();
+    SearchResult result = search.run(limits);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_FALSE(result.bestMove.isNull());
+    EXPECT_GT(result.depth, 0);
+    EXPECT_LT(result.depth, MAX_PLY - 1);
+    EXPECT_GE(ms, limits.movetime - 20);
+    EXPECT_GT(result.stats.hardLimitNodes, 0u);
+    EXPECT_EQ(result.stats.hardLimitNodes % 1024, 0u);
+    EXPECT_EQ(result.nodes, result.stats.hardLimitNodes);
+    EXPECT_EQ(b.toFEN(), fen);
+
+    // The main thread's time running out stops the helpers too, which would otherwise search forever and
+    // keep run from returning
+    LazySMP smp(2);
+    result = smp.run(Board(fen), limits);
+    EXPECT_FALSE(result.bestMove.isNull());
+    EXPECT_LT(result.depth, MAX_PLY - 1);
+    EXPECT_GT(result.stats.hardLimitNodes, 0u);
+    EXPECT_EQ(result.stats.hardLimitNodes % 1024, 0u);
+}
+
+// Walks every line of the given depth, checking at each node that the incrementally kept evaluation sums
+// match a board loaded from scratch
+static void checkIncrementalEval(Board& b, int depth) {
+    Board fresh(b.toFEN());
+    ASSERT_EQ(b.getMidgameScore(), fresh.getMidgameScore()) << b.toFEN();
+    ASSERT_EQ(b.getEndgameScore(), fresh.getEndgameScore()) << b.toFEN();
+    ASSERT_EQ(b.getPhase(), fresh.getPhase()) << b.toFEN();
+    if (depth == 0) {
+        return;
+    }
+    MoveList moves;
+    b.generateMoves(moves);
+    for (Move move : moves) {
+        b.makeMove(move);
+        checkIncrementalEval(b, depth - 1);
+        b.unmakeMove(move);
+    }
+}
+
+TEST(EvaluateTests, testIncremental) {
+    // Castling, en passant, captures and promotions with and without capture
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+    };
+    for (const char* fen : fens) {
+        Board b(fen);
+        int midgame = b.getMidgameScore();
+        checkIncrementalEval(b, 3);
+        EXPECT_EQ(b.getMidgameScore(), midgame);
+    }
+}
+
+TEST(EvaluateTests, testSymmetry) {
+    // The starting position is even, in the middlegame phase
+    Board start;
+    EXPECT_EQ(start.getPhase(), MAX_PHASE);
+    EXPECT_EQ(evaluate(start), 0);
+
+    // A position and its mirror with the colors swapped score the same for the side to move
+    Board b("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    Board mirror("r3k2r/pppbbppp/2n2q1P/1P2p3/3pn3/BN2PNP1/P1PPQPB1/R3K2R b KQkq - 0 1");
+    EXPECT_EQ(evaluate(b), evaluate(mirror));
+    EXPECT_EQ(b.getMidgameScore(), -mirror.getMidgameScore());
+
+    // Bare kings and pawns are scored by the endgame tables: the passed pawn near promotion is worth more
+    Board far("4k3/8/8/8/8/8/P7/4K3 w - - 0 1");
+    Board near("4k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+    EXPECT_EQ(far.getPhase(), 0);
+    EXPECT_GT(evaluate(near), evaluate(far));
+    EXPECT_GT(evaluate(far), 0);
+
+    // The evaluation is from the side to move's point of view
+    Board blackToMove("4k3/P7/8/8/8/8/8/4K3 b - - 0 1");
+    EXPECT_EQ(evaluate(blackToMove), -evaluate(near));
+}
+
+TEST(BoardTests, testNullMove) {
+    const std::string fen = "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3";
+    Board b(fen);
+    Key key = b.getKey();
+
+    // The turn passes and the en passant target is gone, with the key kept up to date
+    b.makeNullMove();
+    EXPECT_FALSE(b.getWhiteToPlay());
+    EXPECT_EQ(b.getEnPassantSquare(), -1);
+    EXPECT_EQ(b.getKey(), b.computeKey());
+    EXPECT_NE(b.getKey(), key);
+    b.unmakeNullMove();
+    EXPECT_EQ(b.toFEN(), fen);
+    EXPECT_EQ(b.getKey(), key);
+
+    // Moves after a null move are taken back as usual
+    b.makeNullMove();
+    Move move(squareFromName("g8"), squareFromName("f6"));
+    b.makeMove(move);
+    EXPECT_EQ(b.getKey(), b.computeKey());
+    b.unmakeMove(move);
+    b.unmakeNullMove();
+    EXPECT_EQ(b.toFEN(), fen);
+}
+
+TEST(SearchTests, testSelectivePruning) {
+    const std::string fen = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    SearchLimits limits;
+    limits.depth = 5;
+
+    Board full(fen);
+    Search fullSearch(full);
+    SearchOptions off;
+    off.nullMove = off.lateMoveReductions = off.futility = off.reverseFutility = off.razoring = false;
+    fullSearch.setOptions(off);
+    SearchResult fullResult = fullSearch.run(limits);
+
+    // The pruned search visits fewer nodes, and leaves the board as it found it
+    Board pruned(fen);
+    Search prunedSearch(pruned);
+    SearchResult prunedResult = prunedSearch.run(limits);
+    EXPECT_EQ(pruned.toFEN(), fen);
+    EXPECT_EQ(prunedResult.depth, 5);
+    EXPECT_LT(prunedResult.nodes, fullResult.nodes);
+
+    // Each technique can be switched off on its own
+    SearchOptions one = off;
+    one.lateMoveReductions = true;
+    Board single(fen);
+    Search singleSearch(single);
+    singleSearch.setOptions(one);
+    EXPECT_LT(singleSearch.run(limits).nodes, fullResult.nodes);
+
+    // Pruning does not miss a mate, nor the win of an undefended queen
+    Board mateIn2("7k/8/5K2/8/8/8/8/R7 w - - 0 1");
+    Search mateSearch(mateIn2);
+    limits.depth = 6;
+    EXPECT_EQ(mateSearch.run(limits).score, VALUE_MATE - 3);
+    Board material("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1");
+    Search materialSearch(material);
+    EXPECT_EQ(materialSearch.run(limits).bestMove, Move(squareFromName("d2"), squareFromName("d5"), CAPTURE));
+}
+
+TEST(TranspositionTableTests, testStoreProbe) {
+    TranspositionTable tt(1);
+    EXPECT_EQ(tt.size(), 1024 * 1024 / 64);
+
+    Key key = 0x123456789ABCDEF0ULL;
+    TTData data;
+    EXPECT_FALSE(tt.probe(key, data));
+
+    Move move(squareFromName("e2"), squareFromName("e4"), DOUBLE_PAWN_PUSH);
+    tt.store(key, move, -VALUE_MATE + 5, 7, BOUND_LOWER);
+    ASSERT_TRUE(tt.probe(key, data));
+    EXPECT_EQ(data.move, move);
+    EXPECT_EQ(data.score, -VALUE_MATE + 5);
+    EXPECT_EQ(data.depth, 7);
+    EXPECT_EQ(data.bound, BOUND_LOWER);
+
+    // A store without a move keeps the move already stored for the position
+    tt.store(key, Move(), 12, 8, BOUND_UPPER);
+    ASSERT_TRUE(tt.probe(key, data));
+    EXPECT_EQ(data.move, move);
+    EXPECT_EQ(data.score, 12);
+
+    // A much shallower bound does not replace a deeper search of the position, an exact score does
+    tt.store(key, Move(), 30, 2, BOUND_LOWER);
+    ASSERT_TRUE(tt.probe(key, data));
+    EXPECT_EQ(data.score, 12);
+    EXPECT_EQ(data.depth, 8);
+    tt.store(key, Move(), 30, 2, BOUND_EXACT);
+    ASSERT_TRUE(tt.probe(key, data));
+    EXPECT_EQ(data.score, 30);
+    EXPECT_EQ(data.depth, 2);
+    EXPECT_EQ(data.move, move);
+
+    // Statistics are counted in the caller's TTStats
+    TTStats stats;
+    EXPECT_TRUE(tt.probe(key, data, &stats));
+    EXPECT_FALSE(tt.probe(key + 1, data, &stats));
+    EXPECT_EQ(stats.probes, 2);
+    EXPECT_EQ(stats.hits, 1);
+
+    tt.clear(4);
+    EXPECT_FALSE(tt.probe(key, data));
+}
+
+TEST(TranspositionTableTests, testReplacement) {
+    TranspositionTable tt(1);
+    Key base = 0x55;
+    Key stride = tt.size();
+    TTData data;
+    TTStats stats;
+
+    // Fill one bucket, then store a fifth position into it: the shallowest entry is replaced
+    for (int i = 0; i < TT_BUCKET_SIZE; i++) {
+        tt.store(base + i * stride, Move(), 0, 10 - i, BOUND_EXACT, &stats);
+    }
+    tt.store(base + TT_BUCKET_SIZE * stride, Move(), 0, 5, BOUND_EXACT, &stats);
+    EXPECT_EQ(stats.collisions, 1);
+    EXPECT_FALSE(tt.probe(base + (TT_BUCKET_SIZE - 1) * stride, data));
+    EXPECT_TRUE(tt.probe(base + TT_BUCKET_SIZE * stride, data));
+    EXPECT_TRUE(tt.probe(base, data));
+
+    // Entries of older searches go first, even when deeper
+    tt.newSearch();
+    tt.store(base + (TT_BUCKET_SIZE + 1) * stride, Move(), 0, 1, BOUND_EXACT, &stats);
+    EXPECT_FALSE(tt.probe(base + TT_BUCKET_SIZE * stride, data));
+    EXPECT_TRUE(tt.probe(base, data));
+    EXPECT_EQ(stats.collisions, 1);
+}
+
+TEST(TranspositionTableTests, testConcurrentAccess) {
+    // Threads storing into the same small table never see an entry that mixes two stores: every hit
+    // returns the data stored with that key
+    TranspositionTable tt(1);
+    TTStats stats[3];
+    auto worker = [&tt, &stats](int id) {
+        TTData data;
+        for (int i = 0; i < 200000; i++) {
+            Key key = Key(i % 5000) * 0x9E3779B97F4A7C15ULL;
+            int score = int(key >> 52);
+            if ((i + id) % 2) {
+                tt.store(key, Move(), score, score & 63, BOUND_EXACT);
+            }
+            else if (tt.probe(key, data, &stats[id])) {
+                EXPECT_EQ(data.score, score);
+                EXPECT_EQ(data.depth, score & 63);
+            }
+        }
+    };
+    std::thread a(worker, 0), b(worker, 1), c(worker, 2);
+    a.join();
+    b.join();
+    c.join();
+    EXPECT_GT(stats[0].hits + stats[1].hits + stats[2].hits, 0);
+    EXPECT_GT(tt.hashfull(), 0);
+}
+
+TEST(SearchTests, testSharedTable) {
+    // A second search of the same position finds the first one's results in the table and visits fewer nodes
+    TranspositionTable tt(4);
+    Board b("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    SearchLimits limits;
+    limits.depth = 4;
+    Search first(b, tt);
+    SearchResult firstResult = first.run(limits);
+    Search second(b, tt);
+    SearchResult secondResult = second.run(limits);
+    EXPECT_LT(secondResult.nodes, firstResult.nodes);
+    EXPECT_EQ(secondResult.score, firstResult.score);
+    EXPECT_GT(secondResult.tableStats.hits, firstResult.tableStats.hits);
+    EXPECT_EQ(secondResult.tableStats.probes, second.getTableStats().probes);
+}
+
+TEST(LazySMPTests, testThreads) {
+    const std::string fen = "7k/8/5K2/8/8/8/8/R7 w - - 0 1";
+    Board b(fen);
+    SearchLimits limits;
+    limits.depth = 6;
+
+    // Helpers on their own boards do not disturb the main thread's result or the caller's board
+    LazySMP smp(4, 4);
+    EXPECT_EQ(smp.getThreads(), 4);
+    SearchResult result = smp.run(b, limits);
+    EXPECT_EQ(result.score, VALUE_MATE - 3);
+    EXPECT_EQ(b.toFEN(), fen);
+
+    Board material("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1");
+    limits.depth = 4;
+    result = smp.run(material, limits);
+    EXPECT_EQ(result.bestMove, Move(squareFromName("d2"), squareFromName("d5"), CAPTURE));
+    EXPECT_EQ(result.depth, 4);
+    EXPECT_GT(result.tableStats.probes, 0);
+    EXPECT_LE(result.tableStats.hits, result.tableStats.probes);
+
+    smp.setThreads(0);
+    EXPECT_EQ(smp.getThreads(), 1);
+}
+
+TEST(LazySMPTests, testStop) {
+    // A search without limits runs until stopped from another thread, then returns its deepest completed iteration
+    LazySMP smp(2, 4);
+    Board b("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    std::thread stopper([&smp]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        smp.stop();
+    });
+    SearchResult result = smp.run(b, SearchLimits());
+    stopper.join();
+    EXPECT_GE(result.depth, 1);
+    EXPECT_TRUE(b.isLegal(result.bestMove));
+}
+
+TEST(ThreadPoolTests, testRunsEveryTask) {
+    ThreadPool pool(4, 8);
+    EXPECT_EQ(pool.size(), 4);
+    EXPECT_EQ(pool.workerIndex(), -1);
+
+    // More tasks than the pool holds: submit blocks until workers make room
+    std::atomic<int> sum(0);
+    for (int i = 1; i <= 1000; i++) {
+        pool.submit([&sum, i]() { sum += i; });
+    }
+    pool.wait();
+    EXPECT_EQ(sum.load(), 500500);
+
+    // Tasks submitted by tasks run too, and never block on the bound
+    std::atomic<int> count(0);
+    for (int i = 0; i < 4; i++) {
+        pool.submit([&pool, &count]() {
+            for (int j = 0; j < 100; j++) {
+                pool.submit([&count]() { count++; });
+            }
+        });
+    }
+    pool.wait();
+    EXPECT_EQ(count.load(), 400);
+}
+
+TEST(ThreadPoolTests, testAffinityAndStealing) {
+    ThreadPool pool(2);
+
+    // One worker is busy with a long task, so the other worker steals the tasks queued behind it
+    std::atomic<bool> release(false);
+    std::atomic<int> busy(-1);
+    std::atomic<int> stolen(0);
+    pool.submit([&pool, &release, &busy]() {
+        busy = pool.workerIndex();
+        while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }, 0);
+    while (busy < 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (int i = 0; i < 10; i++) {
+        pool.submit([&pool, &busy, &stolen]() { stolen += (pool.workerIndex() != busy); }, busy);
+    }
+    while (stolen < 10) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    release = true;
+    pool.wait();
+    EXPECT_EQ(stolen.load(), 10);
+}
+
+TEST(ThreadPoolTests, testException) {
+    ThreadPool pool(2);
+    pool.submit([]() { throw std::runtime_error("task failed"); });
+    pool.submit([]() {});
+    EXPECT_THROW(pool.wait(), std::runtime_error);
+
+    // The error is reported once, the pool keeps working
+    std::atomic<int> count(0);
+    pool.submit([&count]() { count++; });
+    pool.wait();
+    EXPECT_EQ(count.load(), 1);
+}
+
+TEST(ThreadPoolTests, testPerftBatch) {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"
+    };
+    const uint64_t expected[] = { 8902, 97862, 2812, 9467, 62379 };
+
+    // Each task loads its own board, so positions searched at once share nothing
+    uint64_t counts[5] = { 0 };
+    ThreadPool pool(3, 2);
+    for (int i = 0; i < 5; i++) {
+        std::string fen = fens[i];
+        pool.submit([fen, i, &counts]() {
+            Board board;
+            board.loadFromFEN(fen);
+            counts[i] = board.perft(3);
+        });
+    }
+    pool.wait();
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(counts[i], expected[i]) << fens[i];
+    }
+}